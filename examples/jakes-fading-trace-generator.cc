@@ -0,0 +1,60 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/core-module.h"
+#include "ns3/jakes-propagation-loss-model.h"
+#include "ns3/jakes-fading-trace.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup propagation
+ * \brief Writes a cyclic fading trace for the TraceFilename attribute of JakesPropagationLossModel.
+ *
+ * Usage example:
+ *   ./waf --run "jakes-fading-trace-generator --filename=jakes-80Hz.trace --doppler=80 --samples=4000000"
+ */
+int main (int argc, char *argv[])
+{
+  std::string filename = "jakes.trace";
+  double dopplerFrequencyHz = 80;
+  uint32_t nOscillators = 20;
+  double interval = 0.0001;
+  uint32_t nSamples = 1000000;
+  uint32_t run = 1;
+
+  CommandLine cmd;
+  cmd.AddValue ("filename", "Trace file to write", filename);
+  cmd.AddValue ("doppler", "Doppler frequency [Hz]", dopplerFrequencyHz);
+  cmd.AddValue ("oscillators", "Number of oscillators of the sum of sinusoids", nOscillators);
+  cmd.AddValue ("interval", "Sampling interval [s]", interval);
+  cmd.AddValue ("samples", "Number of samples in the trace", nSamples);
+  cmd.AddValue ("run", "Run number used to draw the oscillators", run);
+  cmd.Parse (argc, argv);
+
+  RngSeedManager::SetRun (run);
+  Config::SetDefault ("ns3::JakesProcess::DopplerFrequencyHz", DoubleValue (dopplerFrequencyHz));
+  Config::SetDefault ("ns3::JakesProcess::NumberOfOscillators", UintegerValue (nOscillators));
+
+  Ptr<JakesPropagationLossModel> jakes = CreateObject<JakesPropagationLossModel> ();
+  Ptr<JakesProcess> process = CreateObject<JakesProcess> ();
+  process->SetPropagationLossModel (jakes);
+
+  JakesFadingTrace::Write (filename, process, Seconds (interval), nSamples, dopplerFrequencyHz, nOscillators);
+  std::cout << "Wrote " << nSamples << " samples (" << nSamples * interval << "s) to " << filename << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -29,8 +29,11 @@
 #include "ns3/pointer.h"
 #include "ns3/gnuplot.h"
 #include "ns3/simulator.h"
+#include "ns3/command-line.h"
+#include "propagation-chain.h"
 
 #include <map>
+#include <sstream>
 
 using namespace ns3;
 
@@ -72,17 +75,17 @@ TestDeterministic (Ptr<PropagationLossModel> model)
   {
     a->SetPosition (Vector (0.0, 0.0, 0.0));
 
+    std::vector<double> rxPowerDbm;
+    Time at = Seconds (0.0);
     for (double distance = 0.0; distance < 2500.0; distance += 10.0)
       {
         b->SetPosition (Vector (distance, 0.0, 0.0));
 
-        // CalcRxPower() returns dBm.
-        double rxPowerDbm = model->CalcRxPower (txPowerDbm, a, b);
+        // one sample per distance, a second apart
+        model->Sample (txPowerDbm, a, b, at, Seconds (0.0), 1, rxPowerDbm);
+        at = at + Seconds (1.0);
 
-        dataset.Add (distance, rxPowerDbm);
-
-        Simulator::Stop (Seconds (1.0));
-        Simulator::Run ();
+        dataset.Add (distance, rxPowerDbm[0]);
       }
   }
 
@@ -125,27 +128,25 @@ TestProbabilistic (Ptr<PropagationLossModel> model, unsigned int samples = 10000
 
   typedef std::map<double, unsigned int> rxPowerMapType;
 
-  // Take given number of samples from CalcRxPower() and show probability
+  // Take given number of samples, 10 ms apart, and show probability
   // density for discrete distances.
   {
     a->SetPosition (Vector (0.0, 0.0, 0.0));
 
+    std::vector<double> rxPowerDbm;
+    Time interval = Seconds (0.01);
+    Time at = Seconds (0.0);
     for (double distance = 100.0; distance < 2500.0; distance += 100.0)
       {
         b->SetPosition (Vector (distance, 0.0, 0.0));
 
-        rxPowerMapType rxPowerMap;
+        model->Sample (txPowerDbm, a, b, at, interval, samples, rxPowerDbm);
+        at = at + Seconds (interval.GetSeconds () * samples);
 
+        rxPowerMapType rxPowerMap;
         for (unsigned int samp = 0; samp < samples; ++samp)
           {
-            // CalcRxPower() returns dBm.
-            double rxPowerDbm = model->CalcRxPower (txPowerDbm, a, b);
-            rxPowerDbm = dround (rxPowerDbm, 1.0);
-
-            rxPowerMap[ rxPowerDbm ]++;
-
-            Simulator::Stop (Seconds (0.01));
-            Simulator::Run ();
+            rxPowerMap[ dround (rxPowerDbm[samp], 1.0) ]++;
           }
 
         for (rxPowerMapType::const_iterator i = rxPowerMap.begin ();
@@ -191,17 +192,14 @@ TestDeterministicByTime (Ptr<PropagationLossModel> model,
     a->SetPosition (Vector (0.0, 0.0, 0.0));
     b->SetPosition (Vector (distance, 0.0, 0.0));
 
-    Time start = Simulator::Now ();
-    while( Simulator::Now () < start + timeTotal )
-      {
-        // CalcRxPower() returns dBm.
-        double rxPowerDbm = model->CalcRxPower (txPowerDbm, a, b);
-
-        Time elapsed = Simulator::Now () - start;
-        dataset.Add (elapsed.GetSeconds (), rxPowerDbm);
+    uint32_t n = static_cast<uint32_t> ((timeTotal.GetNanoSeconds () + timeStep.GetNanoSeconds () - 1)
+                                        / timeStep.GetNanoSeconds ());
+    std::vector<double> rxPowerDbm;
+    model->Sample (txPowerDbm, a, b, Seconds (0.0), timeStep, n, rxPowerDbm);
 
-        Simulator::Stop (timeStep);
-        Simulator::Run ();
+    for (uint32_t i = 0; i < n; i++)
+      {
+        dataset.Add (i * timeStep.GetSeconds (), rxPowerDbm[i]);
       }
   }
 
@@ -218,6 +216,15 @@ TestDeterministicByTime (Ptr<PropagationLossModel> model,
 
 int main (int argc, char *argv[])
 {
+  unsigned int samples = 100000;
+  std::string chain;
+
+  CommandLine cmd;
+  cmd.AddValue ("samples", "Number of samples per distance of the probabilistic plots", samples);
+  cmd.AddValue ("chain", "Also plot the distribution of this chain, e.g. "
+                "ns3::ThreeLogDistancePropagationLossModel+ns3::NakagamiPropagationLossModel", chain);
+  cmd.Parse (argc, argv);
+
   GnuplotCollection gnuplots ("main-propagation-loss.pdf");
 
   {
@@ -292,7 +299,7 @@ int main (int argc, char *argv[])
   {
     Ptr<NakagamiPropagationLossModel> nak = CreateObject<NakagamiPropagationLossModel> ();
 
-    Gnuplot plot = TestProbabilistic (nak);
+    Gnuplot plot = TestProbabilistic (nak, samples);
     plot.SetTitle ("ns3::NakagamiPropagationLossModel (Default Parameters)");
     gnuplots.AddPlot (plot);
   }
@@ -303,11 +310,18 @@ int main (int argc, char *argv[])
     Ptr<NakagamiPropagationLossModel> nak = CreateObject<NakagamiPropagationLossModel> ();
     log3->SetNext (nak);
 
-    Gnuplot plot = TestProbabilistic (log3);
+    Gnuplot plot = TestProbabilistic (log3, samples);
     plot.SetTitle ("ns3::ThreeLogDistancePropagationLossModel and ns3::NakagamiPropagationLossModel (Default Parameters)");
     gnuplots.AddPlot (plot);
   }
 
+  if (!chain.empty ())
+    {
+      Gnuplot plot = TestProbabilistic (CreateChain (chain), samples);
+      plot.SetTitle (chain);
+      gnuplots.AddPlot (plot);
+    }
+
   gnuplots.GenerateOutput (std::cout);
 
   // produce clean valgrind
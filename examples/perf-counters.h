@@ -0,0 +1,207 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <string>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \ingroup propagation
+ * \brief Hardware performance counters of the calling thread, for the benchmarks.
+ *
+ * Opens a group of four counters with perf_event_open: cycles,
+ * instructions, cache misses and branch misses, counted in user space
+ * only. Start and Stop enable and disable the group around a measured
+ * region, and the counts of all the regions are added. When the kernel
+ * multiplexes the group with other events, the counts are scaled by the
+ * ratio of the time the group was enabled to the time it ran. When the
+ * counters cannot be opened (not Linux, no PMU in a virtual machine,
+ * kernel.perf_event_paranoid too high...), or the group never ran during
+ * a region, IsAvailable returns false and GetError tells why; Start and
+ * Stop then do nothing.
+ *
+ * The file is only used by the programs of examples/, so it is not part
+ * of the module headers.
+ */
+class PerfCounters
+{
+public:
+  enum Counter
+  {
+    CYCLES,
+    INSTRUCTIONS,
+    CACHE_MISSES,
+    BRANCH_MISSES,
+    N_COUNTERS
+  };
+
+  PerfCounters ()
+  {
+    for (int i = 0; i < N_COUNTERS; i++)
+      {
+        m_fd[i] = -1;
+        m_counts[i] = 0;
+      }
+#ifdef __linux__
+    const uint64_t configs[N_COUNTERS] = {
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_BRANCH_MISSES
+    };
+    for (int i = 0; i < N_COUNTERS; i++)
+      {
+        struct perf_event_attr attr;
+        memset (&attr, 0, sizeof (attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof (attr);
+        attr.config = configs[i];
+        attr.disabled = (i == 0);
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        m_fd[i] = syscall (__NR_perf_event_open, &attr, 0, -1, m_fd[0], 0);
+        if (m_fd[i] < 0)
+          {
+            m_error = std::string ("perf_event_open: ") + strerror (errno);
+            Close ();
+            return;
+          }
+      }
+#else
+    m_error = "perf_event_open is only available on Linux";
+#endif
+  }
+
+  ~PerfCounters ()
+  {
+    Close ();
+  }
+
+  /// \returns true if the counters are open
+  bool IsAvailable (void) const
+  {
+    return m_fd[0] >= 0;
+  }
+
+  /// \returns why the counters are not available
+  std::string GetError (void) const
+  {
+    return m_error;
+  }
+
+  /// Reset the counts of the previous regions
+  void Reset (void)
+  {
+    for (int i = 0; i < N_COUNTERS; i++)
+      {
+        m_counts[i] = 0;
+      }
+  }
+
+  /// Start counting a region
+  void Start (void)
+  {
+#ifdef __linux__
+    if (IsAvailable ())
+      {
+        ioctl (m_fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl (m_fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+      }
+#endif
+  }
+
+  /// Stop counting a region and add its counts
+  void Stop (void)
+  {
+#ifdef __linux__
+    if (IsAvailable ())
+      {
+        ioctl (m_fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        // the number of counters, the times the group was enabled and
+        // running [ns], then the values
+        uint64_t values[3 + N_COUNTERS];
+        if (read (m_fd[0], values, sizeof (values)) != static_cast<ssize_t> (sizeof (values)))
+          {
+            m_error = std::string ("read: ") + strerror (errno);
+            Close ();
+            return;
+          }
+        uint64_t enabled = values[1];
+        uint64_t running = values[2];
+        if (running == 0)
+          {
+            // the group never fit on the PMU: the counts are meaningless
+            m_error = "the counter group could not be scheduled";
+            Close ();
+            return;
+          }
+        // the group was multiplexed with other events: extrapolate
+        double scale = static_cast<double> (enabled) / running;
+        for (int i = 0; i < N_COUNTERS; i++)
+          {
+            m_counts[i] += static_cast<uint64_t> (values[3 + i] * scale + 0.5);
+          }
+      }
+#endif
+  }
+
+  /// \returns the count of counter over the regions since the last Reset
+  uint64_t Get (Counter counter) const
+  {
+    return m_counts[counter];
+  }
+
+  /// \returns the name of counter, as used in the benchmark output
+  static const char * GetName (Counter counter)
+  {
+    static const char *names[N_COUNTERS] = { "cycles", "instructions", "cacheMisses", "branchMisses" };
+    return names[counter];
+  }
+
+private:
+  PerfCounters (const PerfCounters &);
+  PerfCounters & operator = (const PerfCounters &);
+
+  void Close (void)
+  {
+#ifdef __linux__
+    for (int i = N_COUNTERS - 1; i >= 0; i--)
+      {
+        if (m_fd[i] >= 0)
+          {
+            close (m_fd[i]);
+            m_fd[i] = -1;
+          }
+      }
+#endif
+  }
+
+  int m_fd[N_COUNTERS];
+  uint64_t m_counts[N_COUNTERS];
+  std::string m_error;
+};
+
+#endif /* PERF_COUNTERS_H */
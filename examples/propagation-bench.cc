@@ -0,0 +1,357 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/propagation-link-state.h"
+#include "perf-counters.h"
+#include "propagation-chain.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup propagation
+ * \brief Measures the cost per call of the loss and delay models.
+ *
+ * Every registered loss model (found through TypeId::GetRegistered), and
+ * a few common chains, are evaluated from one transmitter to a set of
+ * receivers at random positions:
+ *  - cold: a new model per pass, so every link is seen for the first time
+ *    (the creation of the model is included, amortized over the receivers);
+ *  - warm: the same model and links, pass after pass;
+ * through CalcRxPower ("scalar", the loss alone) and through the batch
+ * Evaluate of PropagationLinkStateEvaluator with a
+ * ConstantSpeedPropagationDelayModel ("linkState"). The latter computes
+ * the delay of every link as well as its loss, so its cost per call is
+ * not comparable to the scalar one; the batch delay alone is the
+ * ConstantSpeedPropagationDelayModel "batch" result. The delay models are
+ * timed with GetDelay, and the constant speed model also with its batch
+ * GetDelayTicks. RecordingPropagationLossModel writes its trace to
+ * propagation-bench.trace.
+ *
+ * The seed, run and streams are fixed, so two builds evaluate the same
+ * links with the same draws. The results are written as JSON:
+ *   ./waf --run "propagation-bench --receivers=1000 --output=bench.json"
+ *
+ * With --perf, each measurement also reads the hardware counters of
+ * PerfCounters, reported per call; if they cannot be opened, the
+ * benchmark runs without them and writes the reason in the JSON.
+ */
+
+/// The result of one measurement
+struct BenchResult
+{
+  std::string m_name;
+  std::string m_path;
+  std::string m_cache;
+  uint64_t m_calls;
+  int64_t m_ms;
+  /// Counts of the PerfCounters, if available
+  uint64_t m_counters[PerfCounters::N_COUNTERS];
+};
+
+/// The receivers and the configuration shared by all measurements
+struct BenchContext
+{
+  Ptr<MobilityModel> m_tx;
+  std::vector<Ptr<MobilityModel> > m_rx;
+  int64_t m_minMs;
+  std::vector<BenchResult> m_results;
+  /// The hardware counters, 0 if not requested
+  PerfCounters *m_perf;
+};
+
+static double g_sink = 0;
+
+/// Start the timer and the counters of a measurement
+static void
+StartRegion (BenchContext &context, SystemWallClockMs &timer)
+{
+  if (context.m_perf != 0)
+    {
+      context.m_perf->Reset ();
+      context.m_perf->Start ();
+    }
+  timer.Start ();
+}
+
+/// Stop the counters and record a measurement started by StartRegion
+static void
+AddResult (BenchContext &context, const std::string &name, const std::string &path,
+           const std::string &cache, uint64_t calls, int64_t ms)
+{
+  BenchResult result;
+  for (int i = 0; i < PerfCounters::N_COUNTERS; i++)
+    {
+      result.m_counters[i] = 0;
+    }
+  if (context.m_perf != 0)
+    {
+      context.m_perf->Stop ();
+      for (int i = 0; i < PerfCounters::N_COUNTERS; i++)
+        {
+          result.m_counters[i] = context.m_perf->Get (static_cast<PerfCounters::Counter> (i));
+        }
+    }
+  result.m_name = name;
+  result.m_path = path;
+  result.m_cache = cache;
+  result.m_calls = calls;
+  result.m_ms = ms;
+  context.m_results.push_back (result);
+  std::cout << name << " " << path << " " << cache << ": "
+            << (ms * 1e6 / calls) << " ns/call" << std::endl;
+}
+
+/// One pass over the receivers, through CalcRxPower (the loss) or the
+/// evaluator (the loss and the delay)
+static void
+Pass (BenchContext &context, Ptr<PropagationLossModel> model,
+      Ptr<PropagationLinkStateEvaluator> evaluator, std::vector<PropagationLinkState> &states)
+{
+  if (evaluator == 0)
+    {
+      for (uint32_t i = 0; i < context.m_rx.size (); i++)
+        {
+          g_sink += model->CalcRxPower (20, context.m_tx, context.m_rx[i]);
+        }
+    }
+  else
+    {
+      evaluator->Evaluate (20, context.m_tx, context.m_rx, states);
+      g_sink += states[0].m_rxPowerDbm;
+    }
+}
+
+static void
+BenchLoss (BenchContext &context, const std::string &spec)
+{
+  Ptr<ConstantSpeedPropagationDelayModel> delay = CreateObject<ConstantSpeedPropagationDelayModel> ();
+  std::vector<PropagationLinkState> states;
+  for (uint32_t batch = 0; batch < 2; batch++)
+    {
+      std::string path = batch ? "linkState" : "scalar";
+      SystemWallClockMs timer;
+      uint64_t passes = 0;
+      int64_t ms = 0;
+      StartRegion (context, timer);
+      do
+        {
+          Ptr<PropagationLossModel> model = CreateChain (spec);
+          Ptr<PropagationLinkStateEvaluator> evaluator;
+          if (batch)
+            {
+              evaluator = CreateObject<PropagationLinkStateEvaluator> ();
+              evaluator->SetLossModel (model);
+              evaluator->SetDelayModel (delay);
+            }
+          Pass (context, model, evaluator, states);
+          passes++;
+          ms = timer.End ();
+        }
+      while (ms < context.m_minMs);
+      AddResult (context, spec, path, "cold", passes * context.m_rx.size (), ms);
+
+      Ptr<PropagationLossModel> model = CreateChain (spec);
+      Ptr<PropagationLinkStateEvaluator> evaluator;
+      if (batch)
+        {
+          evaluator = CreateObject<PropagationLinkStateEvaluator> ();
+          evaluator->SetLossModel (model);
+          evaluator->SetDelayModel (delay);
+        }
+      Pass (context, model, evaluator, states);
+      passes = 0;
+      StartRegion (context, timer);
+      do
+        {
+          Pass (context, model, evaluator, states);
+          passes++;
+          ms = timer.End ();
+        }
+      while (ms < context.m_minMs);
+      AddResult (context, spec, path, "warm", passes * context.m_rx.size (), ms);
+    }
+}
+
+static void
+BenchDelay (BenchContext &context, Ptr<PropagationDelayModel> delay, const std::string &name)
+{
+  delay->AssignStreams (1);
+  SystemWallClockMs timer;
+  uint64_t passes = 0;
+  int64_t ms = 0;
+  StartRegion (context, timer);
+  do
+    {
+      for (uint32_t i = 0; i < context.m_rx.size (); i++)
+        {
+          g_sink += delay->GetDelay (context.m_tx, context.m_rx[i]).GetTimeStep ();
+        }
+      passes++;
+      ms = timer.End ();
+    }
+  while (ms < context.m_minMs);
+  AddResult (context, name, "scalar", "warm", passes * context.m_rx.size (), ms);
+
+  Ptr<ConstantSpeedPropagationDelayModel> constantSpeed = DynamicCast<ConstantSpeedPropagationDelayModel> (delay);
+  if (constantSpeed != 0)
+    {
+      std::vector<int64_t> ticks;
+      passes = 0;
+      StartRegion (context, timer);
+      do
+        {
+          constantSpeed->GetDelayTicks (context.m_tx, context.m_rx, ticks);
+          g_sink += ticks[0];
+          passes++;
+          ms = timer.End ();
+        }
+      while (ms < context.m_minMs);
+      AddResult (context, name, "batch", "warm", passes * context.m_rx.size (), ms);
+    }
+}
+
+static void
+WriteJson (std::ostream &os, const BenchContext &context, uint32_t seed, uint32_t run)
+{
+  bool perf = context.m_perf != 0 && context.m_perf->IsAvailable ();
+  os << "{" << std::endl
+     << "  \"seed\": " << seed << "," << std::endl
+     << "  \"run\": " << run << "," << std::endl
+     << "  \"receivers\": " << context.m_rx.size () << "," << std::endl
+     << "  \"perfCounters\": " << (perf ? "true" : "false") << "," << std::endl;
+  if (context.m_perf != 0 && !perf)
+    {
+      os << "  \"perfError\": \"" << context.m_perf->GetError () << "\"," << std::endl;
+    }
+  os
+     << "  \"results\": [" << std::endl;
+  for (uint32_t i = 0; i < context.m_results.size (); i++)
+    {
+      const BenchResult &result = context.m_results[i];
+      double nsPerCall = result.m_ms * 1e6 / result.m_calls;
+      os << "    { \"model\": \"" << result.m_name << "\", \"path\": \"" << result.m_path
+         << "\", \"cache\": \"" << result.m_cache << "\", \"calls\": " << result.m_calls
+         << ", \"ms\": " << result.m_ms << ", \"nsPerCall\": " << nsPerCall
+         << ", \"callsPerSecond\": " << (nsPerCall > 0 ? 1e9 / nsPerCall : 0);
+      for (int k = 0; perf && k < PerfCounters::N_COUNTERS; k++)
+        {
+          os << ", \"" << PerfCounters::GetName (static_cast<PerfCounters::Counter> (k)) << "PerCall\": "
+             << static_cast<double> (result.m_counters[k]) / result.m_calls;
+        }
+      os << " }"
+         << (i + 1 < context.m_results.size () ? "," : "") << std::endl;
+    }
+  os << "  ]" << std::endl
+     << "}" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nReceivers = 1000;
+  uint32_t minMs = 200;
+  uint32_t seed = 1;
+  uint32_t run = 1;
+  std::string filter = "";
+  std::string output = "propagation-bench.json";
+  bool perf = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("receivers", "Number of receivers of a pass", nReceivers);
+  cmd.AddValue ("minTime", "Minimum duration of a measurement [ms]", minMs);
+  cmd.AddValue ("seed", "Seed of the random number generator", seed);
+  cmd.AddValue ("run", "Run number", run);
+  cmd.AddValue ("filter", "Only time the models whose name contains this", filter);
+  cmd.AddValue ("output", "JSON file to write", output);
+  cmd.AddValue ("perf", "Read the hardware performance counters", perf);
+  cmd.Parse (argc, argv);
+
+  RngSeedManager::SetSeed (seed);
+  RngSeedManager::SetRun (run);
+
+  BenchContext context;
+  context.m_minMs = minMs;
+  context.m_perf = 0;
+  if (perf)
+    {
+      context.m_perf = new PerfCounters ();
+      if (!context.m_perf->IsAvailable ())
+        {
+          std::cout << "Running without hardware counters: " << context.m_perf->GetError () << std::endl;
+        }
+    }
+  context.m_tx = CreateObject<ConstantPositionMobilityModel> ();
+  context.m_tx->SetPosition (Vector (0, 0, 30));
+  Ptr<UniformRandomVariable> position = CreateObject<UniformRandomVariable> ();
+  position->SetStream (0);
+  for (uint32_t i = 0; i < nReceivers; i++)
+    {
+      Ptr<MobilityModel> rx = CreateObject<ConstantPositionMobilityModel> ();
+      rx->SetPosition (Vector (position->GetValue (-1000, 1000), position->GetValue (-1000, 1000), 1.5));
+      context.m_rx.push_back (rx);
+    }
+
+  // every loss model linked into the program, in a stable order
+  std::vector<std::string> models;
+  TypeId base = PropagationLossModel::GetTypeId ();
+  for (uint32_t i = 0; i < TypeId::GetRegisteredN (); i++)
+    {
+      TypeId tid = TypeId::GetRegistered (i);
+      if (tid != base && tid.IsChildOf (base) && tid.HasConstructor ())
+        {
+          models.push_back (tid.GetName ());
+        }
+    }
+  std::sort (models.begin (), models.end ());
+  const char *chains[] = {
+    "ns3::ThreeLogDistancePropagationLossModel+ns3::NakagamiPropagationLossModel",
+    "ns3::LogDistancePropagationLossModel+ns3::NakagamiPropagationLossModel+ns3::BlockFadingPropagationLossModel",
+    "ns3::OkumuraHataPropagationLossModel+ns3::CorrelatedShadowingLossModel",
+    "ns3::FriisPropagationLossModel+ns3::JakesPropagationLossModel",
+  };
+  models.insert (models.end (), chains, chains + sizeof (chains) / sizeof (chains[0]));
+  Config::SetDefault ("ns3::RecordingPropagationLossModel::FileName", StringValue ("propagation-bench.trace"));
+  for (uint32_t i = 0; i < models.size (); i++)
+    {
+      if (models[i].find (filter) != std::string::npos)
+        {
+          BenchLoss (context, models[i]);
+        }
+    }
+  if (std::string ("ns3::RandomPropagationDelayModel").find (filter) != std::string::npos)
+    {
+      BenchDelay (context, CreateObject<RandomPropagationDelayModel> (), "ns3::RandomPropagationDelayModel");
+    }
+  if (std::string ("ns3::ConstantSpeedPropagationDelayModel").find (filter) != std::string::npos)
+    {
+      BenchDelay (context, CreateObject<ConstantSpeedPropagationDelayModel> (), "ns3::ConstantSpeedPropagationDelayModel");
+    }
+
+  std::ofstream os (output.c_str ());
+  WriteJson (os, context, seed, run);
+  std::cout << "Wrote " << context.m_results.size () << " results to " << output << std::endl;
+  delete context.m_perf;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,64 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PROPAGATION_CHAIN_H
+#define PROPAGATION_CHAIN_H
+
+#include "ns3/object-factory.h"
+#include "ns3/abort.h"
+#include "ns3/propagation-loss-model.h"
+#include <sstream>
+#include <string>
+
+/**
+ * \ingroup propagation
+ * \brief Build a chain of loss models from a command line specification
+ * \param spec the type ids of the models, separated by '+', e.g.
+ * "ns3::LogDistancePropagationLossModel+ns3::NakagamiPropagationLossModel"
+ * \param stream the first stream assigned to the chain
+ * \returns the first model of the chain, with its streams assigned
+ *
+ * The streams are fixed, so that two runs of a program evaluate the same
+ * draws. The file is only used by the programs of examples/, so it is
+ * not part of the module headers.
+ */
+inline ns3::Ptr<ns3::PropagationLossModel>
+CreateChain (const std::string &spec, int64_t stream = 1)
+{
+  ns3::Ptr<ns3::PropagationLossModel> first;
+  ns3::Ptr<ns3::PropagationLossModel> last;
+  std::istringstream tokens (spec);
+  std::string name;
+  while (std::getline (tokens, name, '+'))
+    {
+      ns3::ObjectFactory factory;
+      factory.SetTypeId (name);
+      ns3::Ptr<ns3::PropagationLossModel> model = factory.Create<ns3::PropagationLossModel> ();
+      if (first == 0)
+        {
+          first = model;
+        }
+      else
+        {
+          last->SetNext (model);
+        }
+      last = model;
+    }
+  NS_ABORT_MSG_IF (first == 0, "Empty loss model chain");
+  first->AssignStreams (stream);
+  return first;
+}
+
+#endif /* PROPAGATION_CHAIN_H */
@@ -0,0 +1,242 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/recording-propagation-loss-model.h"
+#include "perf-counters.h"
+#include "propagation-chain.h"
+#include <time.h>
+#include <algorithm>
+#include <sstream>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup propagation
+ * \brief Replays a trace of a real simulation on a loss model chain.
+ *
+ * The trace is recorded by a RecordingPropagationLossModel placed first in
+ * the chain of a simulation. This benchmark reads it in memory, then
+ * replays its calls, in order and at their simulation time, on a new
+ * chain, without the rest of the simulation: the only events are one per
+ * recorded time, each making the calls of that time. The cost of the
+ * calls thus reflects the locality of the real run (repeated pairs, calls
+ * clustered in time, moving nodes) rather than that of a synthetic
+ * pattern:
+ *   ./waf --run "propagation-replay-bench --trace=channel.trace \
+ *     --chain=ns3::LogDistancePropagationLossModel+ns3::JakesPropagationLossModel"
+ *
+ * The output gives the locality of the trace: the number of calls, of
+ * distinct (tx, rx) pairs and of distinct times, and the pair reuse, the
+ * fraction of calls on a pair already seen, which bounds the hit rate of
+ * any per-link cache. It then gives the wall time of the calls, the calls
+ * per second and, for each model holding per-link states (see
+ * PropagationLossModel::GetNLinks), the number of states created and the
+ * hit rate 1 - states / calls of its cache. With --perf, the hardware
+ * counters of PerfCounters are added per call.
+ */
+
+static double g_sink = 0;
+
+/// The records of the trace and the state of the replay
+struct Replay
+{
+  std::vector<PropagationTraceRecord> m_records;
+  std::vector<Ptr<MobilityModel> > m_mobility;
+  Ptr<PropagationLossModel> m_chain;
+  /// The hardware counters, 0 if not requested
+  PerfCounters *m_perf;
+  /// Time spent in the calls [ns]
+  int64_t m_ns;
+};
+
+/// \returns the monotonic wall clock [ns]
+static int64_t
+GetNs (void)
+{
+  struct timespec now;
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  return now.tv_sec * static_cast<int64_t> (1000000000) + now.tv_nsec;
+}
+
+/// Replay the records [begin, end), those of one time
+static void
+ReplayTime (Replay *replay, uint32_t begin, uint32_t end)
+{
+  if (replay->m_perf != 0)
+    {
+      replay->m_perf->Start ();
+    }
+  int64_t start = GetNs ();
+  for (uint32_t i = begin; i < end; i++)
+    {
+      const PropagationTraceRecord &record = replay->m_records[i];
+      if (record.m_type == RecordingPropagationLossModel::RECORD_POSITION)
+        {
+          replay->m_mobility[record.m_index]->SetPosition (record.m_position);
+        }
+      else
+        {
+          g_sink += replay->m_chain->CalcRxPower (record.m_txPowerDbm,
+                                                  replay->m_mobility[record.m_tx],
+                                                  replay->m_mobility[record.m_rx]);
+        }
+    }
+  replay->m_ns += GetNs () - start;
+  if (replay->m_perf != 0)
+    {
+      replay->m_perf->Stop ();
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  std::string trace = "propagation.trace";
+  std::string chain = "ns3::ThreeLogDistancePropagationLossModel+ns3::NakagamiPropagationLossModel";
+  uint32_t seed = 1;
+  uint32_t run = 1;
+  bool perf = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("trace", "The trace written by a RecordingPropagationLossModel", trace);
+  cmd.AddValue ("chain", "Type ids of the loss models of the chain, separated by '+'", chain);
+  cmd.AddValue ("seed", "Seed of the random number generator", seed);
+  cmd.AddValue ("run", "Run number", run);
+  cmd.AddValue ("perf", "Read the hardware performance counters", perf);
+  cmd.Parse (argc, argv);
+
+  RngSeedManager::SetSeed (seed);
+  RngSeedManager::SetRun (run);
+
+  Replay replay;
+  PropagationTraceReader reader;
+  reader.Open (trace);
+  PropagationTraceRecord record;
+  uint32_t nMobility = 0;
+  uint64_t nCalls = 0;
+  uint64_t nTimes = 0;
+  int64_t lastTime = -1;
+  std::set<std::pair<uint32_t, uint32_t> > pairs;
+  while (reader.Read (record))
+    {
+      if (record.m_type == RecordingPropagationLossModel::RECORD_POSITION)
+        {
+          nMobility = std::max (nMobility, record.m_index + 1);
+        }
+      else
+        {
+          pairs.insert (std::make_pair (record.m_tx, record.m_rx));
+          if (record.m_timeStep != lastTime)
+            {
+              nTimes++;
+              lastTime = record.m_timeStep;
+            }
+          nCalls++;
+        }
+      replay.m_records.push_back (record);
+    }
+  NS_ABORT_MSG_IF (nCalls == 0, "No call in " << trace);
+
+  std::cout << "# trace " << trace << std::endl
+            << "# chain " << chain << std::endl
+            << "calls " << nCalls << std::endl
+            << "mobilityModels " << nMobility << std::endl
+            << "positionRecords " << replay.m_records.size () - nCalls << std::endl
+            << "pairs " << pairs.size () << std::endl
+            << "pairReuse " << 1 - static_cast<double> (pairs.size ()) / nCalls << std::endl
+            << "times " << nTimes << std::endl
+            << "callsPerTime " << static_cast<double> (nCalls) / nTimes << std::endl;
+
+  for (uint32_t i = 0; i < nMobility; i++)
+    {
+      replay.m_mobility.push_back (CreateObject<ConstantPositionMobilityModel> ());
+    }
+  replay.m_chain = CreateChain (chain);
+  replay.m_ns = 0;
+  replay.m_perf = 0;
+  if (perf)
+    {
+      replay.m_perf = new PerfCounters ();
+      if (!replay.m_perf->IsAvailable ())
+        {
+          std::cout << "# no hardware counters: " << replay.m_perf->GetError () << std::endl;
+          delete replay.m_perf;
+          replay.m_perf = 0;
+        }
+    }
+
+  // one event per recorded time; the position records belong to the time
+  // of the call following them
+  uint32_t begin = 0;
+  while (begin < replay.m_records.size ())
+    {
+      uint32_t end = begin;
+      while (end < replay.m_records.size ()
+             && replay.m_records[end].m_type == RecordingPropagationLossModel::RECORD_POSITION)
+        {
+          end++;
+        }
+      NS_ABORT_MSG_IF (end == replay.m_records.size (), "Position records after the last call");
+      int64_t time = replay.m_records[end].m_timeStep;
+      while (end < replay.m_records.size ()
+             && (replay.m_records[end].m_type == RecordingPropagationLossModel::RECORD_POSITION
+                 || replay.m_records[end].m_timeStep == time))
+        {
+          end++;
+        }
+      // trailing position records, if any, are those of the next time
+      while (end > begin + 1 && replay.m_records[end - 1].m_type == RecordingPropagationLossModel::RECORD_POSITION)
+        {
+          end--;
+        }
+      Simulator::Schedule (TimeStep (time), &ReplayTime, &replay, begin, end);
+      begin = end;
+    }
+  Simulator::Run ();
+
+  std::cout << "ms " << replay.m_ns / 1e6 << std::endl
+            << "callsPerSecond " << nCalls * 1e9 / std::max<int64_t> (replay.m_ns, 1) << std::endl;
+  uint32_t stage = 0;
+  for (Ptr<PropagationLossModel> model = replay.m_chain; model != 0; model = model->GetNext (), stage++)
+    {
+      uint64_t links = model->GetNLinks ();
+      if (links > 0)
+        {
+          std::cout << "stage " << stage << " " << model->GetInstanceTypeId ().GetName ()
+                    << " links " << links
+                    << " hitRate " << 1 - static_cast<double> (links) / nCalls << std::endl;
+        }
+    }
+  if (replay.m_perf != 0 && !replay.m_perf->IsAvailable ())
+    {
+      std::cout << "# no hardware counters: " << replay.m_perf->GetError () << std::endl;
+    }
+  for (int k = 0; replay.m_perf != 0 && replay.m_perf->IsAvailable () && k < PerfCounters::N_COUNTERS; k++)
+    {
+      PerfCounters::Counter counter = static_cast<PerfCounters::Counter> (k);
+      std::cout << PerfCounters::GetName (counter) << "/call "
+                << static_cast<double> (replay.m_perf->Get (counter)) / nCalls << std::endl;
+    }
+
+  delete replay.m_perf;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,174 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/propagation-loss-model.h"
+#include "perf-counters.h"
+#include "propagation-chain.h"
+#include <sys/resource.h>
+#include <sstream>
+#include <algorithm>
+
+using namespace ns3;
+
+/**
+ * \ingroup propagation
+ * \brief Measures how the evaluation of all the links of N nodes scales with N.
+ *
+ * For N = 10, 100, ... up to maxNodes, N nodes are placed uniformly at
+ * random in a square of side area, and the link budget of every pair of
+ * nodes is evaluated once with a new chain. For each N, a line gives the
+ * wall time, the evaluations per second, the peak resident set size of
+ * the process and the number of per-link states held by the chain (see
+ * PropagationLossModel::GetNLinks). Models keeping a state per link, such
+ * as JakesPropagationLossModel, show how their caches grow with the
+ * N(N-1)/2 links:
+ *   ./waf --run "propagation-scaling-bench --maxNodes=10000 \
+ *     --chain=ns3::LogDistancePropagationLossModel+ns3::JakesPropagationLossModel"
+ *
+ * With --perf, the hardware counters of PerfCounters are added to each
+ * line, per evaluation, when they can be opened.
+ *
+ * The peak RSS is that of the whole process: since N grows, it is the
+ * peak of the largest N so far. With maxNodes=100000 the 5 10^9 links do
+ * not fit in memory for models keeping a state per link.
+ */
+
+static double g_sink = 0;
+
+/// \returns the number of per-link states of the models of chain
+static uint64_t
+GetNLinks (Ptr<PropagationLossModel> chain)
+{
+  uint64_t n = 0;
+  for (Ptr<PropagationLossModel> model = chain; model != 0; model = model->GetNext ())
+    {
+      n += model->GetNLinks ();
+    }
+  return n;
+}
+
+/// \returns the peak resident set size of the process [kB]
+static long
+GetPeakRssKb (void)
+{
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t maxNodes = 1000;
+  double area = 10000;
+  std::string chain = "ns3::ThreeLogDistancePropagationLossModel+ns3::NakagamiPropagationLossModel";
+  uint32_t seed = 1;
+  uint32_t run = 1;
+  bool perf = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("maxNodes", "Largest number of nodes, up to 100000", maxNodes);
+  cmd.AddValue ("area", "Side of the square holding the nodes [m]", area);
+  cmd.AddValue ("chain", "Type ids of the loss models of the chain, separated by '+'", chain);
+  cmd.AddValue ("seed", "Seed of the random number generator", seed);
+  cmd.AddValue ("run", "Run number", run);
+  cmd.AddValue ("perf", "Read the hardware performance counters", perf);
+  cmd.Parse (argc, argv);
+
+  RngSeedManager::SetSeed (seed);
+  RngSeedManager::SetRun (run);
+  Ptr<UniformRandomVariable> position = CreateObject<UniformRandomVariable> ();
+  position->SetStream (0);
+
+  std::cout << "# chain " << chain << std::endl;
+  PerfCounters *counters = 0;
+  if (perf)
+    {
+      counters = new PerfCounters ();
+      if (!counters->IsAvailable ())
+        {
+          std::cout << "# no hardware counters: " << counters->GetError () << std::endl;
+          delete counters;
+          counters = 0;
+          perf = false;
+        }
+    }
+  std::cout << "# nodes links ms evaluations/s peakRssKb cachedLinks";
+  for (int k = 0; perf && k < PerfCounters::N_COUNTERS; k++)
+    {
+      std::cout << " " << PerfCounters::GetName (static_cast<PerfCounters::Counter> (k)) << "/evaluation";
+    }
+  std::cout << std::endl;
+  for (uint32_t nNodes = 10; nNodes <= std::min<uint32_t> (maxNodes, 100000); nNodes *= 10)
+    {
+      NodeContainer nodes;
+      nodes.Create (nNodes);
+      std::vector<Ptr<MobilityModel> > mobility;
+      for (uint32_t i = 0; i < nNodes; i++)
+        {
+          Ptr<MobilityModel> model = CreateObject<ConstantPositionMobilityModel> ();
+          model->SetPosition (Vector (position->GetValue (0, area), position->GetValue (0, area), 1.5));
+          nodes.Get (i)->AggregateObject (model);
+          mobility.push_back (model);
+        }
+      Ptr<PropagationLossModel> loss = CreateChain (chain);
+
+      uint64_t nLinks = 0;
+      SystemWallClockMs timer;
+      if (perf)
+        {
+          counters->Reset ();
+          counters->Start ();
+        }
+      timer.Start ();
+      for (uint32_t i = 0; i < nNodes; i++)
+        {
+          for (uint32_t j = i + 1; j < nNodes; j++)
+            {
+              g_sink += loss->CalcRxPower (20, mobility[i], mobility[j]);
+              nLinks++;
+            }
+        }
+      int64_t ms = timer.End ();
+      if (perf)
+        {
+          counters->Stop ();
+        }
+
+      std::cout << nNodes << " " << nLinks << " " << ms << " "
+                << (ms > 0 ? nLinks * 1000.0 / ms : 0) << " "
+                << GetPeakRssKb () << " " << GetNLinks (loss);
+      for (int k = 0; perf && k < PerfCounters::N_COUNTERS; k++)
+        {
+          if (counters->IsAvailable ())
+            {
+              std::cout << " " << static_cast<double> (counters->Get (static_cast<PerfCounters::Counter> (k))) / nLinks;
+            }
+          else
+            {
+              // the group could not be scheduled during this run
+              std::cout << " nan";
+            }
+        }
+      std::cout << std::endl;
+    }
+
+  delete counters;
+  Simulator::Destroy ();
+  return 0;
+}
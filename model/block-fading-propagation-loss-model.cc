@@ -0,0 +1,270 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "block-fading-propagation-loss-model.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/abort.h"
+#include <cmath>
+#include <limits>
+
+NS_LOG_COMPONENT_DEFINE ("BlockFadingPropagationLossModel");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (BlockFadingPropagationLossModel);
+
+TypeId
+BlockFadingPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BlockFadingPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .AddConstructor<BlockFadingPropagationLossModel> ()
+    .AddAttribute ("BlockDuration",
+                   "Duration of a fading block. Zero derives it from DopplerFrequencyHz.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&BlockFadingPropagationLossModel::SetBlockDuration,
+                                     &BlockFadingPropagationLossModel::GetBlockDuration),
+                   MakeTimeChecker ())
+    .AddAttribute ("DopplerFrequencyHz",
+                   "Doppler frequency [Hz] giving the block duration 0.423/f_d when BlockDuration is zero.",
+                   DoubleValue (80),
+                   MakeDoubleAccessor (&BlockFadingPropagationLossModel::SetDopplerFrequencyHz,
+                                       &BlockFadingPropagationLossModel::GetDopplerFrequencyHz),
+                   MakeDoubleChecker<double> (0.0, 1e4))
+    .AddAttribute ("Distribution",
+                   "Distribution of the power gain of a block.",
+                   EnumValue (Rayleigh),
+                   MakeEnumAccessor (&BlockFadingPropagationLossModel::m_distribution),
+                   MakeEnumChecker (Rayleigh, "Rayleigh",
+                                    Nakagami, "Nakagami"))
+    .AddAttribute ("m",
+                   "Fading depth parameter of the Nakagami distribution. Default is 1.",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&BlockFadingPropagationLossModel::m_m),
+                   MakeDoubleChecker<double> (0.5))
+    .AddAttribute ("ExponentialRv",
+                   "Access to the underlying ExponentialRandomVariable",
+                   StringValue ("ns3::ExponentialRandomVariable"),
+                   MakePointerAccessor (&BlockFadingPropagationLossModel::m_exponentialRandomVariable),
+                   MakePointerChecker<ExponentialRandomVariable> ())
+    .AddAttribute ("GammaRv",
+                   "Access to the underlying GammaRandomVariable",
+                   StringValue ("ns3::GammaRandomVariable"),
+                   MakePointerAccessor (&BlockFadingPropagationLossModel::m_gammaRandomVariable),
+                   MakePointerChecker<GammaRandomVariable> ())
+    .AddAttribute ("MaxGainQuantile",
+                   "Quantile of the gain reported by GetMaxGainDb, used to skip the model below a cutoff.",
+                   DoubleValue (0.9999),
+                   MakeDoubleAccessor (&BlockFadingPropagationLossModel::m_maxGainQuantile),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+  ;
+  return tid;
+}
+
+BlockFadingPropagationLossModel::BlockFadingPropagationLossModel ()
+  : m_dopplerFrequencyHz (80),
+    m_blockTicks (1),
+    m_maxGainQuantile (0.9999),
+    m_maxGainDb (0),
+    m_maxGainM (-1),
+    m_maxGainComputedQuantile (-1),
+    m_exponentialDraws (0),
+    m_gammaDraws (0)
+{
+}
+
+uint64_t
+BlockFadingPropagationLossModel::GetNLinks (void) const
+{
+  return m_links.GetN ();
+}
+
+double
+BlockFadingPropagationLossModel::GetMaxGainDb (void) const
+{
+  if (m_maxGainQuantile >= 1)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  if (m_distribution == Rayleigh)
+    {
+      return 10 * std::log10 (-std::log (1 - m_maxGainQuantile));
+    }
+  if (m_maxGainM != m_m || m_maxGainComputedQuantile != m_maxGainQuantile)
+    {
+      m_maxGainM = m_m;
+      m_maxGainComputedQuantile = m_maxGainQuantile;
+      m_maxGainDb = NakagamiPropagationLossModel::GetQuantileDb (m_m, m_maxGainQuantile);
+    }
+  return m_maxGainDb;
+}
+
+void
+BlockFadingPropagationLossModel::SetBlockDuration (Time duration)
+{
+  m_blockDuration = duration;
+  UpdateBlockTicks ();
+}
+
+Time
+BlockFadingPropagationLossModel::GetBlockDuration (void) const
+{
+  return m_blockDuration;
+}
+
+void
+BlockFadingPropagationLossModel::SetDopplerFrequencyHz (double dopplerFrequencyHz)
+{
+  m_dopplerFrequencyHz = dopplerFrequencyHz;
+  UpdateBlockTicks ();
+}
+
+double
+BlockFadingPropagationLossModel::GetDopplerFrequencyHz (void) const
+{
+  return m_dopplerFrequencyHz;
+}
+
+void
+BlockFadingPropagationLossModel::UpdateBlockTicks (void)
+{
+  Time duration = m_blockDuration;
+  if (duration.IsZero () && m_dopplerFrequencyHz > 0)
+    {
+      duration = Seconds (0.423 / m_dopplerFrequencyHz);
+    }
+  // without Doppler the channel never changes: a single block
+  m_blockTicks = duration.IsStrictlyPositive () ? duration.GetTimeStep () : std::numeric_limits<int64_t>::max ();
+  m_links.Clear ();
+}
+
+const BlockFadingPropagationLossModel::LinkState &
+BlockFadingPropagationLossModel::GetLinkState (Ptr<MobilityModel> a,
+                                               Ptr<MobilityModel> b) const
+{
+  int64_t block = GetEvaluationTime ().GetTimeStep () / m_blockTicks;
+  LinkState *state = m_links.GetPathData (a, b, 0);
+  if (state == 0)
+    {
+      LinkState initial;
+      initial.m_block = block - 1;
+      initial.m_gain = 1;
+      initial.m_gainDb = 0;
+      state = &m_links.AddPathData (initial, a, b, 0);
+    }
+  if (state->m_block != block)
+    {
+      double gain;
+      if (m_distribution == Rayleigh)
+        {
+          gain = m_exponentialRandomVariable->GetValue (1.0, 0);
+          m_exponentialDraws++;
+        }
+      else
+        {
+          gain = m_gammaRandomVariable->GetValue (m_m, 1.0 / m_m);
+          m_gammaDraws++;
+        }
+      state->m_block = block;
+      state->m_gain = gain;
+      state->m_gainDb = 10 * std::log10 (gain);
+      NS_LOG_DEBUG ("block=" << block << ", gain=" << state->m_gainDb << "dB");
+    }
+  return *state;
+}
+
+BlockFadingPropagationLossModel::PowerDomain
+BlockFadingPropagationLossModel::GetPowerDomain (void) const
+{
+  return DOMAIN_ANY;
+}
+
+double
+BlockFadingPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                                Ptr<MobilityModel> a,
+                                                Ptr<MobilityModel> b) const
+{
+  return txPowerDbm + GetLinkState (a, b).m_gainDb;
+}
+
+double
+BlockFadingPropagationLossModel::DoCalcRxPowerW (double txPowerW,
+                                                 Ptr<MobilityModel> a,
+                                                 Ptr<MobilityModel> b) const
+{
+  return txPowerW * GetLinkState (a, b).m_gain;
+}
+
+int64_t
+BlockFadingPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  m_exponentialRandomVariable->SetStream (stream);
+  m_gammaRandomVariable->SetStream (stream + 1);
+  return 2;
+}
+
+void
+BlockFadingPropagationLossModel::DoSerialize (std::ostream &os) const
+{
+  PropagationSnapshot::WriteU64 (os, m_exponentialDraws);
+  PropagationSnapshot::WriteU64 (os, m_gammaDraws);
+  PropagationSnapshot::WriteU32 (os, m_links.GetN ());
+  for (PropagationArena<LinkState>::Iterator it = m_links.Begin (); it != m_links.End (); ++it)
+    {
+      const LinkState &state = m_links.Get (it->second);
+      PropagationSnapshot::WriteMobility (os, it->first.m_srcMobility);
+      PropagationSnapshot::WriteMobility (os, it->first.m_dstMobility);
+      PropagationSnapshot::WriteU64 (os, state.m_block);
+      PropagationSnapshot::WriteDouble (os, state.m_gain);
+    }
+}
+
+void
+BlockFadingPropagationLossModel::DoDeserialize (std::istream &is)
+{
+  NS_ABORT_MSG_IF (m_exponentialDraws != 0 || m_gammaDraws != 0,
+                   "A snapshot can only be restored into an unused BlockFadingPropagationLossModel");
+  // the shape m is an attribute, so every Gamma draw consumed alike
+  uint64_t exponentialDraws = PropagationSnapshot::ReadU64 (is);
+  uint64_t gammaDraws = PropagationSnapshot::ReadU64 (is);
+  for (; m_exponentialDraws < exponentialDraws; m_exponentialDraws++)
+    {
+      m_exponentialRandomVariable->GetValue (1.0, 0);
+    }
+  for (; m_gammaDraws < gammaDraws; m_gammaDraws++)
+    {
+      m_gammaRandomVariable->GetValue (m_m, 1.0 / m_m);
+    }
+  m_links.Clear ();
+  uint32_t n = PropagationSnapshot::ReadU32 (is);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<MobilityModel> a = PropagationSnapshot::ReadMobility (is);
+      Ptr<MobilityModel> b = PropagationSnapshot::ReadMobility (is);
+      LinkState state;
+      state.m_block = PropagationSnapshot::ReadU64 (is);
+      state.m_gain = PropagationSnapshot::ReadDouble (is);
+      state.m_gainDb = 10 * std::log10 (state.m_gain);
+      m_links.AddPathData (state, a, b, 0);
+    }
+}
+
+} // namespace ns3
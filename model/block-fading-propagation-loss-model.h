@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef BLOCK_FADING_PROPAGATION_LOSS_MODEL_H
+#define BLOCK_FADING_PROPAGATION_LOSS_MODEL_H
+
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-cache.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Block fading: one random gain per link and coherence block.
+ *
+ * Time is divided into blocks of BlockDuration, starting at time 0. The
+ * first call for a link within a block draws a new power gain, which is
+ * then returned for every call on that link until the block ends. The
+ * gain is exponentially distributed (Rayleigh fading) or Gamma
+ * distributed with shape m and scale 1/m (Nakagami-m fading); in both
+ * cases its mean is 1.
+ *
+ * If BlockDuration is zero, it is derived from the Doppler frequency as
+ * the coherence time \f$ T_c = \frac{0.423}{f_d} \f$.
+ *
+ * Compared with ns3::JakesPropagationLossModel this costs one random draw
+ * per link and block instead of a sum of sinusoids per call, and gives
+ * no correlation between consecutive blocks.
+ *
+ * The gain is applied in dBm or in Watt, whichever the chain carries
+ * (see PropagationLossModel::GetPowerDomain).
+ */
+class BlockFadingPropagationLossModel : public PropagationLossModel
+{
+public:
+  static TypeId GetTypeId (void);
+  BlockFadingPropagationLossModel ();
+
+  /// The distribution of the power gain of a block
+  enum Distribution
+  {
+    Rayleigh, Nakagami
+  };
+
+  void SetBlockDuration (Time duration);
+  Time GetBlockDuration (void) const;
+
+  void SetDopplerFrequencyHz (double dopplerFrequencyHz);
+  double GetDopplerFrequencyHz (void) const;
+
+  /// \returns the MaxGainQuantile quantile of the gain
+  virtual double GetMaxGainDb (void) const;
+  /// \returns the number of links with a gain
+  virtual uint64_t GetNLinks (void) const;
+
+private:
+  BlockFadingPropagationLossModel (const BlockFadingPropagationLossModel &o);
+  BlockFadingPropagationLossModel & operator = (const BlockFadingPropagationLossModel &o);
+
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual double DoCalcRxPowerW (double txPowerW,
+                                 Ptr<MobilityModel> a,
+                                 Ptr<MobilityModel> b) const;
+  virtual PowerDomain GetPowerDomain (void) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+  virtual void DoSerialize (std::ostream &os) const;
+  virtual void DoDeserialize (std::istream &is);
+  void UpdateBlockTicks (void);
+
+  /// Per link state
+  struct LinkState
+  {
+    /// Index of the block the gain was drawn for
+    int64_t m_block;
+    double m_gain;
+    double m_gainDb;
+  };
+  /// \returns the state of the link between a and b, with the gain of the current block
+  const LinkState & GetLinkState (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
+  Time m_blockDuration;
+  double m_dopplerFrequencyHz;
+  /// Effective block duration in time steps
+  int64_t m_blockTicks;
+  Distribution m_distribution;
+  double m_m;
+  double m_maxGainQuantile;
+  /// GetMaxGainDb of the Nakagami distribution, and the m and quantile it was computed for
+  mutable double m_maxGainDb;
+  mutable double m_maxGainM;
+  mutable double m_maxGainComputedQuantile;
+
+  Ptr<ExponentialRandomVariable> m_exponentialRandomVariable;
+  Ptr<GammaRandomVariable> m_gammaRandomVariable;
+
+  mutable PropagationArena<LinkState> m_links;
+  mutable uint64_t m_exponentialDraws;
+  mutable uint64_t m_gammaDraws;
+};
+
+} // namespace ns3
+
+#endif /* BLOCK_FADING_PROPAGATION_LOSS_MODEL_H */
@@ -0,0 +1,253 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "correlated-shadowing-loss-model.h"
+#include "propagation-fft.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/abort.h"
+#include "ns3/mobility-model.h"
+#include <cmath>
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("CorrelatedShadowingLossModel");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (CorrelatedShadowingLossModel);
+
+TypeId
+CorrelatedShadowingLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CorrelatedShadowingLossModel")
+    .SetParent<PropagationLossModel> ()
+    .AddConstructor<CorrelatedShadowingLossModel> ()
+    .AddAttribute ("Bounds",
+                   "The area covered by the shadowing map.",
+                   RectangleValue (Rectangle (0.0, 1000.0, 0.0, 1000.0)),
+                   MakeRectangleAccessor (&CorrelatedShadowingLossModel::SetBounds,
+                                          &CorrelatedShadowingLossModel::GetBounds),
+                   MakeRectangleChecker ())
+    .AddAttribute ("Resolution",
+                   "The distance between two points of the map (m).",
+                   DoubleValue (10.0),
+                   MakeDoubleAccessor (&CorrelatedShadowingLossModel::SetResolution,
+                                       &CorrelatedShadowingLossModel::GetResolution),
+                   MakeDoubleChecker<double> (0.01))
+    .AddAttribute ("DecorrelationDistance",
+                   "The distance at which the correlation of the shadowing falls to 1/e (m).",
+                   DoubleValue (50.0),
+                   MakeDoubleAccessor (&CorrelatedShadowingLossModel::SetDecorrelationDistance,
+                                       &CorrelatedShadowingLossModel::GetDecorrelationDistance),
+                   MakeDoubleChecker<double> (0.01))
+    .AddAttribute ("Sigma",
+                   "The standard deviation of the shadowing (dB).",
+                   DoubleValue (8.0),
+                   MakeDoubleAccessor (&CorrelatedShadowingLossModel::SetSigma,
+                                       &CorrelatedShadowingLossModel::GetSigma),
+                   MakeDoubleChecker<double> (0.0))
+  ;
+  return tid;
+}
+
+CorrelatedShadowingLossModel::CorrelatedShadowingLossModel ()
+  : m_resolution (10.0),
+    m_decorrelationDistance (50.0),
+    m_sigma (8.0),
+    m_nx (0),
+    m_ny (0)
+{
+  m_normalVariable = CreateObject<NormalRandomVariable> ();
+}
+
+CorrelatedShadowingLossModel::~CorrelatedShadowingLossModel ()
+{
+}
+
+void
+CorrelatedShadowingLossModel::SetBounds (Rectangle bounds)
+{
+  m_bounds = bounds;
+  m_field.clear ();
+}
+
+Rectangle
+CorrelatedShadowingLossModel::GetBounds (void) const
+{
+  return m_bounds;
+}
+
+void
+CorrelatedShadowingLossModel::SetResolution (double resolution)
+{
+  m_resolution = resolution;
+  m_field.clear ();
+}
+
+double
+CorrelatedShadowingLossModel::GetResolution (void) const
+{
+  return m_resolution;
+}
+
+void
+CorrelatedShadowingLossModel::SetDecorrelationDistance (double distance)
+{
+  m_decorrelationDistance = distance;
+  m_field.clear ();
+}
+
+double
+CorrelatedShadowingLossModel::GetDecorrelationDistance (void) const
+{
+  return m_decorrelationDistance;
+}
+
+void
+CorrelatedShadowingLossModel::SetSigma (double sigma)
+{
+  m_sigma = sigma;
+  m_field.clear ();
+}
+
+double
+CorrelatedShadowingLossModel::GetSigma (void) const
+{
+  return m_sigma;
+}
+
+void
+CorrelatedShadowingLossModel::GenerateField (void) const
+{
+  NS_ABORT_MSG_IF (m_bounds.xMax < m_bounds.xMin || m_bounds.yMax < m_bounds.yMin,
+                   "Invalid shadowing map bounds");
+  m_nx = static_cast<uint32_t> (std::ceil ((m_bounds.xMax - m_bounds.xMin) / m_resolution)) + 1;
+  m_ny = static_cast<uint32_t> (std::ceil ((m_bounds.yMax - m_bounds.yMin) / m_resolution)) + 1;
+  // pad by 4 decorrelation distances: the cyclic correlation between the
+  // edges of the map stays below e^-4
+  uint32_t margin = static_cast<uint32_t> (std::ceil (4 * m_decorrelationDistance / m_resolution));
+  uint32_t cols = 1;
+  while (cols < m_nx + margin)
+    {
+      cols <<= 1;
+    }
+  uint32_t rows = 1;
+  while (rows < m_ny + margin)
+    {
+      rows <<= 1;
+    }
+  NS_LOG_DEBUG ("Generating a " << m_nx << "x" << m_ny << " shadowing map on a "
+                                << cols << "x" << rows << " grid");
+
+  // spectrum of the cyclic exponential correlation
+  std::vector<std::complex<double> > spectrum (rows * cols);
+  for (uint32_t r = 0; r < rows; r++)
+    {
+      double dy = std::min (r, rows - r) * m_resolution;
+      for (uint32_t c = 0; c < cols; c++)
+        {
+          double dx = std::min (c, cols - c) * m_resolution;
+          double d = std::sqrt (dx * dx + dy * dy);
+          spectrum[r * cols + c] = m_sigma * m_sigma * std::exp (-d / m_decorrelationDistance);
+        }
+    }
+  PropagationFft2d (spectrum, rows, cols, false);
+
+  std::vector<std::complex<double> > noise (rows * cols);
+  for (uint32_t i = 0; i < noise.size (); i++)
+    {
+      noise[i] = m_normalVariable->GetValue ();
+    }
+  PropagationFft2d (noise, rows, cols, false);
+  for (uint32_t i = 0; i < noise.size (); i++)
+    {
+      // the sampled correlation is positive definite up to rounding
+      noise[i] *= std::sqrt (std::max (spectrum[i].real (), 0.0));
+    }
+  PropagationFft2d (noise, rows, cols, true);
+
+  m_field.resize (m_nx * m_ny);
+  for (uint32_t j = 0; j < m_ny; j++)
+    {
+      for (uint32_t i = 0; i < m_nx; i++)
+        {
+          m_field[j * m_nx + i] = noise[j * cols + i].real ();
+        }
+    }
+}
+
+double
+CorrelatedShadowingLossModel::GetShadowing (const Vector &position) const
+{
+  if (m_field.empty ())
+    {
+      GenerateField ();
+    }
+  double x = (std::min (std::max (position.x, m_bounds.xMin), m_bounds.xMax) - m_bounds.xMin) / m_resolution;
+  double y = (std::min (std::max (position.y, m_bounds.yMin), m_bounds.yMax) - m_bounds.yMin) / m_resolution;
+  uint32_t i = std::min (static_cast<uint32_t> (x), m_nx > 1 ? m_nx - 2 : 0);
+  uint32_t j = std::min (static_cast<uint32_t> (y), m_ny > 1 ? m_ny - 2 : 0);
+  uint32_t i1 = std::min (i + 1, m_nx - 1);
+  uint32_t j1 = std::min (j + 1, m_ny - 1);
+  double fx = std::min (x - i, 1.0);
+  double fy = std::min (y - j, 1.0);
+  double bottom = m_field[j * m_nx + i] * (1 - fx) + m_field[j * m_nx + i1] * fx;
+  double top = m_field[j1 * m_nx + i] * (1 - fx) + m_field[j1 * m_nx + i1] * fx;
+  return bottom * (1 - fy) + top * fy;
+}
+
+double
+CorrelatedShadowingLossModel::DoCalcRxPower (double txPowerDbm,
+                                             Ptr<MobilityModel> a,
+                                             Ptr<MobilityModel> b) const
+{
+  double loss = (GetShadowing (a->GetPosition ()) + GetShadowing (b->GetPosition ())) / std::sqrt (2.0);
+  NS_LOG_DEBUG ("shadowing loss=" << loss << "dB");
+  return txPowerDbm - loss;
+}
+
+int64_t
+CorrelatedShadowingLossModel::DoAssignStreams (int64_t stream)
+{
+  m_normalVariable->SetStream (stream);
+  return 1;
+}
+
+void
+CorrelatedShadowingLossModel::DoSerialize (std::ostream &os) const
+{
+  // the map is the whole state: its generation consumed all the draws
+  PropagationSnapshot::WriteU32 (os, m_field.empty () ? 0 : m_nx);
+  PropagationSnapshot::WriteU32 (os, m_field.empty () ? 0 : m_ny);
+  for (uint32_t i = 0; i < m_field.size (); i++)
+    {
+      PropagationSnapshot::WriteDouble (os, m_field[i]);
+    }
+}
+
+void
+CorrelatedShadowingLossModel::DoDeserialize (std::istream &is)
+{
+  m_nx = PropagationSnapshot::ReadU32 (is);
+  m_ny = PropagationSnapshot::ReadU32 (is);
+  m_field.resize (m_nx * m_ny);
+  for (uint32_t i = 0; i < m_field.size (); i++)
+    {
+      m_field[i] = PropagationSnapshot::ReadDouble (is);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,106 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef CORRELATED_SHADOWING_LOSS_MODEL_H
+#define CORRELATED_SHADOWING_LOSS_MODEL_H
+
+#include "ns3/propagation-loss-model.h"
+#include "ns3/rectangle.h"
+#include "ns3/vector.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Log-normal shadowing from a spatially correlated map
+ *
+ * A Gaussian shadowing field \f$S(x, y)\f$ [dB] with standard deviation
+ * Sigma and the exponential autocorrelation of Gudmundson,
+ * \f[ E[S(p) S(q)] = \sigma^2 e^{-|p - q| / d_c} \f]
+ * is generated once over the Bounds rectangle, on a grid of Resolution
+ * meters. White Gaussian noise is filtered in the frequency domain by the
+ * square root of the spectrum of the correlation function, on a grid
+ * padded by several decorrelation distances so that the cyclic
+ * convolution does not correlate opposite edges.
+ *
+ * A call reads the field at both positions with bilinear interpolation
+ * and applies the loss
+ * \f[ L = \frac{S(a) + S(b)}{\sqrt{2}} \f]
+ * which is symmetric and has standard deviation \f$\sigma\f$ for distant
+ * nodes. Calls draw no random value, and a node keeps its shadowing as
+ * long as it does not move. Positions outside Bounds are clamped to it;
+ * the height is ignored.
+ *
+ * This model only adds shadowing: chain it after a path loss model, e.g.
+ * \code
+ *   Ptr<OkumuraHataPropagationLossModel> pathLoss = CreateObject<OkumuraHataPropagationLossModel> ();
+ *   pathLoss->SetNext (CreateObject<CorrelatedShadowingLossModel> ());
+ * \endcode
+ *
+ * The field is generated on the first call, so that AssignStreams can be
+ * called first; changing an attribute discards it.
+ */
+class CorrelatedShadowingLossModel : public PropagationLossModel
+{
+public:
+  static TypeId GetTypeId (void);
+  CorrelatedShadowingLossModel ();
+  virtual ~CorrelatedShadowingLossModel ();
+
+  void SetBounds (Rectangle bounds);
+  Rectangle GetBounds (void) const;
+  void SetResolution (double resolution);
+  double GetResolution (void) const;
+  void SetDecorrelationDistance (double distance);
+  double GetDecorrelationDistance (void) const;
+  void SetSigma (double sigma);
+  double GetSigma (void) const;
+
+  /**
+   * \param position a position, clamped to Bounds
+   * \returns the shadowing field \f$S\f$ [dB] at position
+   */
+  double GetShadowing (const Vector &position) const;
+
+private:
+  CorrelatedShadowingLossModel (const CorrelatedShadowingLossModel &o);
+  CorrelatedShadowingLossModel & operator = (const CorrelatedShadowingLossModel &o);
+
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+  virtual void DoSerialize (std::ostream &os) const;
+  virtual void DoDeserialize (std::istream &is);
+  void GenerateField (void) const;
+
+  Rectangle m_bounds;
+  double m_resolution;
+  double m_decorrelationDistance;
+  double m_sigma;
+  Ptr<NormalRandomVariable> m_normalVariable;
+
+  /// Number of grid points along x and y
+  mutable uint32_t m_nx;
+  mutable uint32_t m_ny;
+  /// Row major field, m_field[j * m_nx + i] at (xMin + i res, yMin + j res)
+  mutable std::vector<double> m_field;
+};
+
+} // namespace ns3
+
+#endif /* CORRELATED_SHADOWING_LOSS_MODEL_H */
@@ -160,7 +160,7 @@ double
 Cost231PropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
 {
 
-  double distance = a->GetDistanceFrom (b);
+  double distance = GetDistance (a, b);
   if (distance <= m_minDistance)
     {
       return 0.0;
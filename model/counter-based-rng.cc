@@ -0,0 +1,263 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "counter-based-rng.h"
+#include "propagation-snapshot.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/abort.h"
+#include <cmath>
+#include <algorithm>
+
+namespace ns3 {
+
+CounterBasedRng::CounterBasedRng ()
+  : m_stream (-1),
+    m_used (4),
+    m_nextNormal (0),
+    m_hasNextNormal (false),
+    m_linkSlot (-1)
+{
+  m_key[0] = 0;
+  m_key[1] = 0;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      m_counter[i] = 0;
+      m_output[i] = 0;
+    }
+}
+
+void
+CounterBasedRng::SetStream (int64_t stream)
+{
+  m_stream = stream;
+  m_linkBlocks.Clear ();
+  m_linkSlot = -1;
+}
+
+int64_t
+CounterBasedRng::GetStream (void) const
+{
+  return m_stream;
+}
+
+uint64_t
+CounterBasedRng::GetNLinks (void) const
+{
+  return m_linkBlocks.GetN ();
+}
+
+uint64_t
+CounterBasedRng::GetLinkIndex (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b)
+{
+  Ptr<Node> nodeA = a->GetObject<Node> ();
+  Ptr<Node> nodeB = b->GetObject<Node> ();
+  NS_ABORT_MSG_IF (nodeA == 0 || nodeB == 0,
+                   "Counter-based streams need mobility models aggregated to nodes");
+  uint64_t first = std::min (nodeA->GetId (), nodeB->GetId ());
+  uint64_t second = std::max (nodeA->GetId (), nodeB->GetId ());
+  return (first << 32) | second;
+}
+
+void
+CounterBasedRng::Seek (uint64_t link, uint32_t block)
+{
+  NS_ABORT_MSG_IF (m_stream < 0, "Counter-based streams need AssignStreams to be called first");
+  m_key[0] = RngSeedManager::GetSeed ();
+  m_key[1] = static_cast<uint32_t> (m_stream);
+  m_counter[0] = static_cast<uint32_t> (link);
+  m_counter[1] = static_cast<uint32_t> (link >> 32);
+  m_counter[2] = block;
+  m_counter[3] = static_cast<uint32_t> (RngSeedManager::GetRun ());
+  m_used = 4;
+  m_hasNextNormal = false;
+  m_linkSlot = -1;
+}
+
+void
+CounterBasedRng::Seek (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t block)
+{
+  Seek (GetLinkIndex (a, b), block);
+}
+
+void
+CounterBasedRng::SeekLink (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b)
+{
+  uint32_t *block = m_linkBlocks.GetPathData (a, b, 0);
+  if (block == 0)
+    {
+      block = &m_linkBlocks.AddPathData (0, a, b, 0);
+    }
+  Seek (a, b, *block);
+  m_linkSlot = block - &m_linkBlocks.Get (0);
+}
+
+uint32_t
+CounterBasedRng::GetBlock (void) const
+{
+  // a partly used block is not reused
+  return m_used == 4 ? m_counter[2] : m_counter[2] + 1;
+}
+
+double
+CounterBasedRng::GetUniform (void)
+{
+  if (m_used == 4)
+    {
+      NextBlock ();
+    }
+  uint32_t high = m_output[m_used] >> 5;
+  uint32_t low = m_output[m_used + 1] >> 6;
+  m_used += 2;
+  // 53 bits, shifted by half a step to exclude 0 and 1
+  return (high * 67108864.0 + low + 0.5) / 9007199254740992.0;
+}
+
+double
+CounterBasedRng::GetNormal (void)
+{
+  if (m_hasNextNormal)
+    {
+      m_hasNextNormal = false;
+      return m_nextNormal;
+    }
+  double radius = std::sqrt (-2 * std::log (GetUniform ()));
+  double angle = 2 * M_PI * GetUniform ();
+  m_nextNormal = radius * std::sin (angle);
+  m_hasNextNormal = true;
+  return radius * std::cos (angle);
+}
+
+void
+CounterBasedRng::GetNormals (double *normals, uint32_t n)
+{
+  uint32_t i = 0;
+  if (n > 0 && m_hasNextNormal)
+    {
+      m_hasNextNormal = false;
+      normals[i++] = m_nextNormal;
+    }
+  for (; i + 1 < n; i += 2)
+    {
+      double radius = std::sqrt (-2 * std::log (GetUniform ()));
+      double angle = 2 * M_PI * GetUniform ();
+      normals[i] = radius * std::cos (angle);
+      normals[i + 1] = radius * std::sin (angle);
+    }
+  if (i < n)
+    {
+      normals[i] = GetNormal ();
+    }
+}
+
+double
+CounterBasedRng::GetGamma (double alpha, double beta)
+{
+  if (alpha < 1)
+    {
+      double u = GetUniform ();
+      return GetGamma (1 + alpha, beta) * std::pow (u, 1 / alpha);
+    }
+  // G. Marsaglia and W. W. Tsang, "A Simple Method for Generating Gamma
+  // Variables", ACM TOMS, Vol. 26, pp 363-372, 2000
+  double d = alpha - 1.0 / 3;
+  double c = 1 / std::sqrt (9 * d);
+  while (true)
+    {
+      double x;
+      double v;
+      do
+        {
+          x = GetNormal ();
+          v = 1 + c * x;
+        }
+      while (v <= 0);
+      v = v * v * v;
+      double u = GetUniform ();
+      if (u < 1 - 0.0331 * x * x * x * x
+          || std::log (u) < 0.5 * x * x + d * (1 - v + std::log (v)))
+        {
+          return beta * d * v;
+        }
+    }
+}
+
+void
+CounterBasedRng::NextBlock (void)
+{
+  Philox4x32 (m_counter, m_key, m_output);
+  m_counter[2]++;
+  m_used = 0;
+  if (m_linkSlot >= 0)
+    {
+      m_linkBlocks.Get (m_linkSlot) = m_counter[2];
+    }
+}
+
+void
+CounterBasedRng::Write (std::ostream &os) const
+{
+  PropagationSnapshot::WriteU32 (os, m_linkBlocks.GetN ());
+  for (PropagationArena<uint32_t>::Iterator it = m_linkBlocks.Begin (); it != m_linkBlocks.End (); ++it)
+    {
+      PropagationSnapshot::WriteMobility (os, it->first.m_srcMobility);
+      PropagationSnapshot::WriteMobility (os, it->first.m_dstMobility);
+      PropagationSnapshot::WriteU32 (os, m_linkBlocks.Get (it->second));
+    }
+}
+
+void
+CounterBasedRng::Read (std::istream &is)
+{
+  m_linkBlocks.Clear ();
+  m_linkSlot = -1;
+  uint32_t n = PropagationSnapshot::ReadU32 (is);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<MobilityModel> a = PropagationSnapshot::ReadMobility (is);
+      Ptr<MobilityModel> b = PropagationSnapshot::ReadMobility (is);
+      m_linkBlocks.AddPathData (PropagationSnapshot::ReadU32 (is), a, b, 0);
+    }
+}
+
+void
+CounterBasedRng::Philox4x32 (const uint32_t counter[4], const uint32_t key[2], uint32_t result[4])
+{
+  const uint64_t m0 = 0xD2511F53;
+  const uint64_t m1 = 0xCD9E8D57;
+  uint32_t c[4] = { counter[0], counter[1], counter[2], counter[3] };
+  uint32_t k0 = key[0];
+  uint32_t k1 = key[1];
+  for (uint32_t round = 0; round < 10; round++)
+    {
+      uint64_t p0 = m0 * c[0];
+      uint64_t p1 = m1 * c[2];
+      uint32_t next[4] =
+      {
+        static_cast<uint32_t> (p1 >> 32) ^ c[1] ^ k0,
+        static_cast<uint32_t> (p1),
+        static_cast<uint32_t> (p0 >> 32) ^ c[3] ^ k1,
+        static_cast<uint32_t> (p0)
+      };
+      std::copy (next, next + 4, c);
+      k0 += 0x9E3779B9;
+      k1 += 0xBB67AE85;
+    }
+  std::copy (c, c + 4, result);
+}
+
+} // namespace ns3
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef COUNTER_BASED_RNG_H
+#define COUNTER_BASED_RNG_H
+
+#include "ns3/ptr.h"
+#include "ns3/propagation-cache.h"
+#include <iostream>
+#include <stdint.h>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Per-link random variates from the Philox4x32-10 generator
+ *
+ * Philox [1] is a counter-based generator: block i of a sequence is a
+ * keyed bijection of i, so any block can be computed without computing
+ * the previous ones. Here the key is made of the global seed and of the
+ * stream number of the model, and the counter of the canonical index of
+ * the link (the ids of both nodes), the index of the block within the
+ * link sequence, and the run number. The variates of a link thus only
+ * depend on the seed, run, stream and on the draws made for that link,
+ * not on the order in which links are evaluated.
+ *
+ * A model positions the generator on a link with SeekLink, which resumes
+ * the sequence of the link where the previous draws for that link
+ * stopped, and draws. Each block of 128 bits gives two uniform variates
+ * of 53 bits.
+ *
+ * [1] J. K. Salmon, M. A. Moraes, R. O. Dror and D. E. Shaw, "Parallel
+ * Random Numbers: As Easy as 1, 2, 3", Proc. SC11, 2011
+ */
+class CounterBasedRng
+{
+public:
+  CounterBasedRng ();
+
+  /// Set the stream number, usually from AssignStreams; this restarts the sequence of every link
+  void SetStream (int64_t stream);
+  /// \returns the stream number, negative if none was assigned
+  int64_t GetStream (void) const;
+
+  /**
+   * \returns the index of the link between the nodes of a and b, the same
+   * for both directions
+   *
+   * Both mobility models must be aggregated to a node.
+   */
+  static uint64_t GetLinkIndex (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b);
+
+  /**
+   * \brief Position the generator on a link sequence
+   * \param link the index of the link, see GetLinkIndex
+   * \param block the index of the next block of the link sequence
+   *
+   * The seed and run are read from RngSeedManager.
+   */
+  void Seek (uint64_t link, uint32_t block);
+  /// Same as Seek (GetLinkIndex (a, b), block)
+  void Seek (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t block);
+  /// \returns the index of the next unused block of the current link sequence
+  uint32_t GetBlock (void) const;
+  /**
+   * \brief Resume the sequence of the link between a and b
+   *
+   * The first call for a link starts its sequence at block 0; the next
+   * ones start after the last block drawn for that link.
+   */
+  void SeekLink (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b);
+
+  /// \returns the number of link sequences started by SeekLink
+  uint64_t GetNLinks (void) const;
+
+  /// Save the position of every link sequence, see PropagationLossModel::Serialize
+  void Write (std::ostream &os) const;
+  /// Restore the positions saved by Write
+  void Read (std::istream &is);
+
+  /// \returns a uniform variate in (0, 1)
+  double GetUniform (void);
+  /// \returns a standard normal variate
+  double GetNormal (void);
+  /**
+   * \brief Draw n standard normal variates in a row
+   * \param normals receives the variates
+   * \param n the number of variates
+   *
+   * The variates are those of n calls to GetNormal, computed by Box-Muller
+   * pairs from the uniforms of one block each, without going through the
+   * second value of the pair in between.
+   */
+  void GetNormals (double *normals, uint32_t n);
+  /// \returns a Gamma variate of shape alpha and scale beta
+  double GetGamma (double alpha, double beta);
+
+  /// The Philox4x32 bijection with 10 rounds
+  static void Philox4x32 (const uint32_t counter[4], const uint32_t key[2], uint32_t result[4]);
+
+private:
+  /// Generate the block m_counter points to, and move to the next one
+  void NextBlock (void);
+
+  int64_t m_stream;
+  uint32_t m_key[2];
+  uint32_t m_counter[4];
+  /// Output of the current block, and the number of its words used
+  uint32_t m_output[4];
+  uint32_t m_used;
+  /// Second value of the last Box-Muller pair
+  double m_nextNormal;
+  bool m_hasNextNormal;
+  /// Next block of every link sequence started by SeekLink
+  PropagationArena<uint32_t> m_linkBlocks;
+  /// Index in m_linkBlocks of the current link, or -1 after Seek
+  int64_t m_linkSlot;
+};
+
+} // namespace ns3
+
+#endif /* COUNTER_BASED_RNG_H */
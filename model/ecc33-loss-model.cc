@@ -174,7 +174,7 @@ double
 ECC33PathLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
 {
 
-  double distance = a->GetDistanceFrom (b);
+  double distance = GetDistance (a, b);
   double distance_km = distance / 1000;
   if (distance_km <= m_minDistance)
     {
@@ -0,0 +1,228 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "filtered-gaussian-fading-process.h"
+#include "propagation-fft.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "propagation-loss-model.h"
+#include "jakes-propagation-loss-model.h"
+#include "propagation-snapshot.h"
+#include <cmath>
+
+NS_LOG_COMPONENT_DEFINE ("FilteredGaussianFadingProcess");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (FilteredGaussianFadingProcess);
+
+/// Whether a process was already evaluated past the period of its block
+static bool g_periodExceeded = false;
+
+TypeId
+FilteredGaussianFadingProcess::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::FilteredGaussianFadingProcess")
+    .SetParent<Object> ()
+    .AddConstructor<FilteredGaussianFadingProcess> ()
+    .AddAttribute ("DopplerFrequencyHz", "Corresponding doppler frequency[Hz]",
+                   DoubleValue (80),
+                   MakeDoubleAccessor (&FilteredGaussianFadingProcess::m_dopplerFrequencyHz),
+                   MakeDoubleChecker<double> (0.0, 1e4))
+    .AddAttribute ("NumberOfSamples",
+                   "The number of samples of the cyclic block, a power of two. Each link holds its "
+                   "block, 16 bytes per sample (256 KiB at the default), and snapshots save it whole. "
+                   "The fading repeats every NumberOfSamples * SampleInterval (8.192 s by default).",
+                   UintegerValue (16384),
+                   MakeUintegerAccessor (&FilteredGaussianFadingProcess::m_nSamples),
+                   MakeUintegerChecker<uint32_t> (16, 1 << 24))
+    .AddAttribute ("SampleInterval", "The time between two samples of the block",
+                   TimeValue (MicroSeconds (500)),
+                   MakeTimeAccessor (&FilteredGaussianFadingProcess::m_sampleInterval),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+FilteredGaussianFadingProcess::FilteredGaussianFadingProcess () :
+  m_dopplerFrequencyHz (0),
+  m_nSamples (0)
+{
+}
+
+FilteredGaussianFadingProcess::~FilteredGaussianFadingProcess ()
+{
+  m_samples.clear ();
+}
+
+void
+FilteredGaussianFadingProcess::DoDispose ()
+{
+  m_jakes = 0;
+}
+
+void
+FilteredGaussianFadingProcess::SetPropagationLossModel (Ptr<const PropagationLossModel> propagationModel)
+{
+  Ptr<const JakesPropagationLossModel> jakes = propagationModel->GetObject<JakesPropagationLossModel> ();
+  NS_ASSERT_MSG (jakes != 0, "FilteredGaussianFadingProcess can work only with JakesPropagationLossModel!");
+  m_jakes = jakes;
+  Generate ();
+}
+
+void
+FilteredGaussianFadingProcess::Serialize (std::ostream &os) const
+{
+  PropagationSnapshot::WriteDouble (os, m_dopplerFrequencyHz);
+  PropagationSnapshot::WriteU64 (os, m_sampleInterval.GetTimeStep ());
+  PropagationSnapshot::WriteU32 (os, m_nSamples);
+  for (uint32_t i = 0; i < m_nSamples; i++)
+    {
+      PropagationSnapshot::WriteDouble (os, m_samples[i].real ());
+      PropagationSnapshot::WriteDouble (os, m_samples[i].imag ());
+    }
+}
+
+void
+FilteredGaussianFadingProcess::Deserialize (std::istream &is, Ptr<const PropagationLossModel> propagationModel)
+{
+  Ptr<const JakesPropagationLossModel> jakes = propagationModel->GetObject<JakesPropagationLossModel> ();
+  NS_ASSERT_MSG (jakes != 0, "FilteredGaussianFadingProcess can work only with JakesPropagationLossModel!");
+  m_jakes = jakes;
+  m_dopplerFrequencyHz = PropagationSnapshot::ReadDouble (is);
+  m_sampleInterval = TimeStep (PropagationSnapshot::ReadU64 (is));
+  m_nSamples = PropagationSnapshot::ReadU32 (is);
+  m_samples.resize (m_nSamples);
+  for (uint32_t i = 0; i < m_nSamples; i++)
+    {
+      double re = PropagationSnapshot::ReadDouble (is);
+      double im = PropagationSnapshot::ReadDouble (is);
+      m_samples[i] = std::complex<double> (re, im);
+    }
+}
+
+void
+FilteredGaussianFadingProcess::Generate ()
+{
+  NS_ASSERT (m_jakes);
+  NS_ABORT_MSG_UNLESS (PropagationFftIsPowerOfTwo (m_nSamples),
+                       "NumberOfSamples must be a power of two");
+  const uint32_t n = m_nSamples;
+  // normalized Doppler frequency and index of the band edge
+  double fm = m_dopplerFrequencyHz * m_sampleInterval.GetSeconds ();
+  uint32_t km = static_cast<uint32_t> (std::floor (fm * n));
+  NS_ABORT_MSG_IF (km < 1, "The block is shorter than 1/f_d: increase NumberOfSamples or SampleInterval");
+  NS_ABORT_MSG_IF (2 * km >= n, "SampleInterval must be shorter than 1/(2 f_d)");
+
+  // filter of Young and Beaulieu, eq. (21)
+  std::vector<double> filter (n, 0);
+  for (uint32_t k = 1; k < km; k++)
+    {
+      double ratio = k / (n * fm);
+      filter[k] = std::sqrt (1 / (2 * std::sqrt (1 - ratio * ratio)));
+      filter[n - k] = filter[k];
+    }
+  filter[km] = std::sqrt (km / 2.0 * (JakesPropagationLossModel::PI / 2
+                                      - std::atan ((km - 1.0) / std::sqrt (2.0 * km - 1))));
+  filter[n - km] = filter[km];
+
+  double filterPower = 0;
+  m_samples.resize (n);
+  for (uint32_t k = 0; k < n; k++)
+    {
+      // the variates are drawn for every bin, so that the draw count only
+      // depends on NumberOfSamples
+      double a = m_jakes->DrawNormal ();
+      double b = m_jakes->DrawNormal ();
+      m_samples[k] = std::complex<double> (filter[k] * a, -filter[k] * b);
+      filterPower += filter[k] * filter[k];
+    }
+  PropagationFft (m_samples, true);
+
+  // E|x_n|^2 = 2 sum F_k^2 / N^2, scaled to 2
+  double scale = n / std::sqrt (filterPower);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_samples[i] *= scale;
+    }
+  NS_LOG_DEBUG ("Generated " << n << " samples, k_m=" << km);
+}
+
+std::complex<double>
+FilteredGaussianFadingProcess::GetComplexGain () const
+{
+  return GetComplexGain (Now ());
+}
+
+std::complex<double>
+FilteredGaussianFadingProcess::GetComplexGain (Time at) const
+{
+  NS_ASSERT (!m_samples.empty ());
+  double position = at.GetSeconds () / m_sampleInterval.GetSeconds ();
+  if (position >= m_nSamples && !g_periodExceeded)
+    {
+      g_periodExceeded = true;
+      NS_LOG_WARN ("Evaluated at " << at.GetSeconds () << "s, past the period of "
+                   << m_nSamples * m_sampleInterval.GetSeconds () << "s of the cyclic block: "
+                   << "the fading repeats; increase NumberOfSamples or SampleInterval");
+    }
+  position = std::fmod (position, static_cast<double> (m_nSamples));
+  if (position < 0)
+    {
+      position += m_nSamples;
+    }
+  uint32_t i = static_cast<uint32_t> (position);
+  double fraction = position - i;
+  i %= m_nSamples;
+  uint32_t next = (i + 1) % m_nSamples;
+  return m_samples[i] * (1 - fraction) + m_samples[next] * fraction;
+}
+
+double
+FilteredGaussianFadingProcess::GetChannelGainDb () const
+{
+  return GetChannelGainDb (Now ());
+}
+
+double
+FilteredGaussianFadingProcess::GetChannelGainDb (Time at) const
+{
+  std::complex<double> complexGain = GetComplexGain (at);
+  return (10 * std::log10 ((std::pow (complexGain.real (), 2) + std::pow (complexGain.imag (), 2)) / 2));
+}
+
+double
+FilteredGaussianFadingProcess::GetDopplerFrequencyHz () const
+{
+  return m_dopplerFrequencyHz;
+}
+
+uint32_t
+FilteredGaussianFadingProcess::GetNSamples () const
+{
+  return m_nSamples;
+}
+
+std::complex<double>
+FilteredGaussianFadingProcess::GetSample (uint32_t n) const
+{
+  return m_samples[n % m_nSamples];
+}
+
+} // namespace ns3
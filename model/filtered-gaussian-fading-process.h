@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef FILTERED_GAUSSIAN_FADING_PROCESS_H
+#define FILTERED_GAUSSIAN_FADING_PROCESS_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include <complex>
+#include <vector>
+#include <iostream>
+
+namespace ns3
+{
+class PropagationLossModel;
+class JakesPropagationLossModel;
+/**
+ * \ingroup fading
+ *
+ * \brief Rayleigh fading of a single path synthesized by filtering
+ * complex Gaussian noise with the Clarke/Jakes Doppler spectrum.
+ *
+ * The process is generated once, as a cyclic block of N samples spaced
+ * by \f$T_s\f$, with the inverse DFT method of [1]: the independent
+ * Gaussian variates \f$A_k, B_k \sim N(0, 1)\f$ are shaped by the filter
+ * \f$F_k\f$ sampling the square root of the Doppler spectrum
+ * \f$ S(f) \propto 1 / \sqrt{1 - (f/f_d)^2} \f$ (with the band edge
+ * \f$k_m = \lfloor f_d T_s N \rfloor\f$ integrated as in [1]), and
+ * \f[ x_n = \frac{1}{N} \sum_{k=0}^{N-1} F_k (A_k - j B_k) e^{j 2 \pi k n / N} \f]
+ * The block is scaled to \f$E|x_n|^2 = 2\f$, the normalization of
+ * JakesProcess, so that both processes share the gain formula. Values
+ * between samples are interpolated linearly and time wraps around the
+ * block.
+ *
+ * The cost is one FFT per link, i.e. \f$O(\log N)\f$ per sample, instead
+ * of NumberOfOscillators cosines per evaluation, and the memory is the
+ * block, 16 N bytes per link: 256 KiB at the default N = 16384. The period
+ * \f$N T_s\f$ should cover many coherence times \f$1/f_d\f$; the block
+ * must satisfy \f$ 1 \le f_d T_s N \f$ and \f$ f_d T_s < 1/2 \f$. The
+ * fading is periodic: with the defaults it repeats exactly every
+ * 8.192 s, and the first evaluation past one period logs a warning.
+ * Traces longer than the period need a larger N or \f$T_s\f$.
+ *
+ * [1] D. J. Young and N. C. Beaulieu, "The Generation of Correlated
+ * Rayleigh Random Variates by Inverse Discrete Fourier Transform",
+ * IEEE Trans. on Communications, Vol. 48, pp 1114-1127, July 2000
+ */
+class FilteredGaussianFadingProcess : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  FilteredGaussianFadingProcess ();
+  virtual ~FilteredGaussianFadingProcess ();
+  virtual void DoDispose ();
+  std::complex<double> GetComplexGain () const;
+  /// Get the complex gain at moment \param at
+  std::complex<double> GetComplexGain (Time at) const;
+  /// Get Channel gain [dB]
+  double GetChannelGainDb () const;
+  /// Get Channel gain [dB] at moment \param at
+  double GetChannelGainDb (Time at) const;
+  /// \returns the maximum Doppler frequency [Hz]
+  double GetDopplerFrequencyHz () const;
+  /// \returns the number of samples N of the cyclic block
+  uint32_t GetNSamples () const;
+  /// \returns the sample \param n of the cyclic block
+  std::complex<double> GetSample (uint32_t n) const;
+  /// Draw the Gaussian variates from the model and generate the block
+  void SetPropagationLossModel (Ptr<const PropagationLossModel>);
+  /// Save the block, see PropagationLossModel::Serialize
+  void Serialize (std::ostream &os) const;
+  /// Restore the block saved by Serialize instead of generating a new one
+  void Deserialize (std::istream &is, Ptr<const PropagationLossModel> propagationModel);
+private:
+  void Generate ();
+private:
+  /// The cyclic block of complex gains
+  std::vector<std::complex<double> > m_samples;
+  ///\name Attributes:
+  ///\{
+  double m_dopplerFrequencyHz;
+  uint32_t m_nSamples;
+  Time m_sampleInterval;
+  Ptr<const JakesPropagationLossModel> m_jakes;
+  ///\}
+};
+} // namespace ns3
+#endif // FILTERED_GAUSSIAN_FADING_PROCESS_H
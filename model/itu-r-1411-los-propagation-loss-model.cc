@@ -53,7 +53,7 @@ double
 ItuR1411LosPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
 {
   NS_LOG_FUNCTION (this);
-  double dist = a->GetDistanceFrom (b);
+  double dist = GetDistance (a, b);
   double lossLow = 0.0;
   double lossUp = 0.0;
   NS_ASSERT_MSG (a->GetPosition ().z > 0 && b->GetPosition ().z > 0, "nodes' height must be greater than 0");
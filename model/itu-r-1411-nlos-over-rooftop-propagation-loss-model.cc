@@ -120,7 +120,7 @@ ItuR1411NlosOverRooftopPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<
       Lori = 2.5 + 0.075 * (m_streetsOrientation - 55);
     }
 
-  double distance = a->GetDistanceFrom (b);
+  double distance = GetDistance (a, b);
   double hb = (a->GetPosition ().z > b->GetPosition ().z ? a->GetPosition ().z : b->GetPosition ().z);
   double hm = (a->GetPosition ().z < b->GetPosition ().z ? a->GetPosition ().z : b->GetPosition ().z);
   NS_ASSERT_MSG (hm > 0 && hb > 0, "nodes' height must be greater then 0");
@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "jakes-fading-trace.h"
+#include "jakes-process.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+NS_LOG_COMPONENT_DEFINE ("JakesFadingTrace");
+
+namespace ns3 {
+
+static const char TRACE_MAGIC[8] = { 'J', 'A', 'K', 'E', 'S', 'T', 'R', 'C' };
+static const uint32_t TRACE_VERSION = 1;
+
+JakesFadingTrace::JakesFadingTrace () :
+  m_mapping (0),
+  m_mappingLength (0),
+  m_samples (0),
+  m_nSamples (0),
+  m_sampleInterval (0),
+  m_inverseSampleInterval (0),
+  m_dopplerFrequencyHz (0)
+{
+}
+
+JakesFadingTrace::~JakesFadingTrace ()
+{
+  Close ();
+}
+
+void
+JakesFadingTrace::Write (std::string filename, Ptr<const JakesProcess> process, Time interval,
+                         uint32_t nSamples, double dopplerFrequencyHz, uint32_t nOscillators)
+{
+  NS_ABORT_MSG_IF (nSamples < 2, "A fading trace needs at least two samples");
+  NS_ABORT_MSG_IF (!interval.IsStrictlyPositive (), "The sampling interval must be positive");
+
+  std::ofstream os (filename.c_str (), std::ios::binary | std::ios::trunc);
+  NS_ABORT_MSG_IF (!os.is_open (), "Can't open fading trace file " << filename);
+
+  Header header;
+  std::memset (&header, 0, sizeof (header));
+  std::memcpy (header.m_magic, TRACE_MAGIC, sizeof (TRACE_MAGIC));
+  header.m_version = TRACE_VERSION;
+  header.m_nSamples = nSamples;
+  header.m_sampleInterval = interval.GetSeconds ();
+  header.m_dopplerFrequencyHz = dopplerFrequencyHz;
+  header.m_nOscillators = nOscillators;
+  os.write (reinterpret_cast<const char *> (&header), sizeof (header));
+
+  for (uint32_t i = 0; i < nSamples; i++)
+    {
+      std::complex<double> gain = process->GetComplexGain (interval * i);
+      float sample[2] = { static_cast<float> (gain.real ()), static_cast<float> (gain.imag ()) };
+      os.write (reinterpret_cast<const char *> (sample), sizeof (sample));
+    }
+  NS_ABORT_MSG_IF (!os.good (), "Error while writing fading trace file " << filename);
+}
+
+void
+JakesFadingTrace::Open (std::string filename)
+{
+  Close ();
+
+  int fd = open (filename.c_str (), O_RDONLY);
+  NS_ABORT_MSG_IF (fd < 0, "Can't open fading trace file " << filename);
+  struct stat st;
+  NS_ABORT_MSG_IF (fstat (fd, &st) != 0, "Can't stat fading trace file " << filename);
+  NS_ABORT_MSG_IF (static_cast<size_t> (st.st_size) < sizeof (Header), filename << " is not a fading trace");
+
+  m_mappingLength = st.st_size;
+  m_mapping = mmap (0, m_mappingLength, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  NS_ABORT_MSG_IF (m_mapping == MAP_FAILED, "Can't map fading trace file " << filename);
+
+  const Header *header = static_cast<const Header *> (m_mapping);
+  NS_ABORT_MSG_IF (std::memcmp (header->m_magic, TRACE_MAGIC, sizeof (TRACE_MAGIC)) != 0
+                   || header->m_version != TRACE_VERSION,
+                   filename << " is not a version " << TRACE_VERSION << " fading trace");
+  NS_ABORT_MSG_IF (header->m_nSamples < 2 || header->m_sampleInterval <= 0, filename << " has an invalid header");
+  NS_ABORT_MSG_IF (m_mappingLength < sizeof (Header) + 2 * sizeof (float) * header->m_nSamples,
+                   filename << " is truncated");
+
+  m_nSamples = header->m_nSamples;
+  m_sampleInterval = header->m_sampleInterval;
+  m_inverseSampleInterval = 1.0 / m_sampleInterval;
+  m_dopplerFrequencyHz = header->m_dopplerFrequencyHz;
+  m_samples = reinterpret_cast<const float *> (static_cast<const char *> (m_mapping) + sizeof (Header));
+  NS_LOG_INFO ("Mapped " << m_nSamples << " samples of " << m_sampleInterval << "s from " << filename);
+}
+
+void
+JakesFadingTrace::Close (void)
+{
+  if (m_mapping != 0)
+    {
+      munmap (m_mapping, m_mappingLength);
+    }
+  m_mapping = 0;
+  m_mappingLength = 0;
+  m_samples = 0;
+  m_nSamples = 0;
+}
+
+std::complex<double>
+JakesFadingTrace::GetComplexGain (double t) const
+{
+  NS_ASSERT (m_samples != 0);
+  double position = std::fmod (t * m_inverseSampleInterval, static_cast<double> (m_nSamples));
+  if (position < 0)
+    {
+      position += m_nSamples;
+    }
+  uint32_t i = static_cast<uint32_t> (position);
+  if (i >= m_nSamples)
+    {
+      // fmod result rounded up to m_nSamples
+      i = 0;
+      position = 0;
+    }
+  uint32_t j = (i + 1 == m_nSamples) ? 0 : i + 1;
+  double w = position - i;
+  const float *s0 = m_samples + 2 * i;
+  const float *s1 = m_samples + 2 * j;
+  return std::complex<double> (s0[0] + w * (s1[0] - s0[0]), s0[1] + w * (s1[1] - s0[1]));
+}
+
+double
+JakesFadingTrace::GetChannelGainDb (double t) const
+{
+  std::complex<double> complexGain = GetComplexGain (t);
+  return (10 * std::log10 ((complexGain.real () * complexGain.real () + complexGain.imag () * complexGain.imag ()) / 2));
+}
+
+double
+JakesFadingTrace::GetDuration (void) const
+{
+  return m_nSamples * m_sampleInterval;
+}
+
+double
+JakesFadingTrace::GetDopplerFrequencyHz (void) const
+{
+  return m_dopplerFrequencyHz;
+}
+
+} // namespace ns3
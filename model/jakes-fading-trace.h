@@ -0,0 +1,106 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef JAKES_FADING_TRACE_H
+#define JAKES_FADING_TRACE_H
+
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include <complex>
+#include <string>
+#include <stdint.h>
+
+namespace ns3
+{
+class JakesProcess;
+/**
+ * \ingroup fading
+ *
+ * \brief A precomputed, cyclic fading trace mapped read-only from a file.
+ *
+ * The trace is a sequence of complex gains sampled at a fixed interval
+ * from a JakesProcess, i.e. with the same sum-of-sinusoids construction
+ * used by JakesPropagationLossModel. Files are produced offline by
+ * JakesFadingTrace::Write (see the jakes-fading-trace-generator example)
+ * and mapped with mmap at run time, so that all simulations reading the
+ * same file share its pages.
+ *
+ * File layout (host byte order): a Header, followed by
+ * Header::m_nSamples pairs of float (real, imaginary).
+ *
+ * The trace is read cyclically: time t is taken modulo the trace
+ * duration and the gain is linearly interpolated between the two
+ * neighbouring complex samples. The sum of sinusoids is not periodic, so
+ * the trace should be long compared with the coherence time in order to
+ * make the wrap-around discontinuity irrelevant.
+ */
+class JakesFadingTrace : public SimpleRefCount<JakesFadingTrace>
+{
+public:
+  /// On-disk header of a trace file
+  struct Header
+  {
+    char m_magic[8];
+    uint32_t m_version;
+    uint32_t m_nSamples;
+    double m_sampleInterval; ///< seconds
+    double m_dopplerFrequencyHz;
+    uint32_t m_nOscillators;
+    uint32_t m_reserved;
+  };
+
+  JakesFadingTrace ();
+  ~JakesFadingTrace ();
+
+  /**
+   * \brief Sample process and write the resulting trace to filename
+   * \param filename the trace file to create
+   * \param process a JakesProcess which has already been attached to a JakesPropagationLossModel
+   * \param interval the sampling interval
+   * \param nSamples the number of samples to write
+   * \param dopplerFrequencyHz the Doppler frequency of process, stored for reference
+   * \param nOscillators the number of oscillators of process, stored for reference
+   */
+  static void Write (std::string filename, Ptr<const JakesProcess> process, Time interval,
+                     uint32_t nSamples, double dopplerFrequencyHz, uint32_t nOscillators);
+
+  /// Map the trace file filename. Aborts the simulation if it is not a valid trace.
+  void Open (std::string filename);
+
+  /// \returns the complex gain at t seconds from the start of the trace (cyclic)
+  std::complex<double> GetComplexGain (double t) const;
+  /// \returns the channel gain [dB] at t seconds from the start of the trace (cyclic)
+  double GetChannelGainDb (double t) const;
+  /// \returns the duration of the trace in seconds
+  double GetDuration (void) const;
+  /// \returns the Doppler frequency the trace was generated with
+  double GetDopplerFrequencyHz (void) const;
+
+private:
+  JakesFadingTrace (const JakesFadingTrace &o);
+  JakesFadingTrace & operator = (const JakesFadingTrace &o);
+  void Close (void);
+
+  void * m_mapping;
+  size_t m_mappingLength;
+  const float * m_samples;
+  uint32_t m_nSamples;
+  double m_sampleInterval;
+  double m_inverseSampleInterval;
+  double m_dopplerFrequencyHz;
+};
+} // namespace ns3
+#endif // JAKES_FADING_TRACE_H
@@ -25,6 +25,7 @@
 #include "ns3/uinteger.h"
 #include "propagation-loss-model.h"
 #include "jakes-propagation-loss-model.h"
+#include "propagation-snapshot.h"
 
 NS_LOG_COMPONENT_DEFINE ("JakesProcess");
 
@@ -59,6 +60,22 @@ JakesProcess::GetTypeId ()
                    UintegerValue (20),
                    MakeUintegerAccessor (&JakesProcess::SetNOscillators),
                    MakeUintegerChecker<unsigned int> (4, 1000))
+    .AddAttribute ("NumberOfTxAntennas", "The number of transmit antennas of the channel matrix",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&JakesProcess::m_nTxAntennas),
+                   MakeUintegerChecker<uint32_t> (1, 64))
+    .AddAttribute ("NumberOfRxAntennas", "The number of receive antennas of the channel matrix",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&JakesProcess::m_nRxAntennas),
+                   MakeUintegerChecker<uint32_t> (1, 64))
+    .AddAttribute ("TxCorrelation", "Correlation rho of adjacent transmit antennas, R_ij = rho^|i-j|",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&JakesProcess::m_txCorrelation),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("RxCorrelation", "Correlation rho of adjacent receive antennas, R_ij = rho^|i-j|",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&JakesProcess::m_rxCorrelation),
+                   MakeDoubleChecker<double> (0.0, 1.0))
   ;
   return tid;
 }
@@ -74,6 +91,94 @@ JakesProcess::SetPropagationLossModel (Ptr<const PropagationLossModel> propagati
   NS_ASSERT (m_omegaDopplerMax != 0);
   
   ConstructOscillators ();
+  ConstructAntennas ();
+}
+
+void
+JakesProcess::Serialize (std::ostream &os) const
+{
+  PropagationSnapshot::WriteDouble (os, m_omegaDopplerMax);
+  PropagationSnapshot::WriteU32 (os, m_nOscillators);
+  PropagationSnapshot::WriteU32 (os, m_taps.size ());
+  for (unsigned int l = 0; l < m_taps.size (); l++)
+    {
+      PropagationSnapshot::WriteDouble (os, m_taps[l].m_delay);
+      PropagationSnapshot::WriteDouble (os, m_taps[l].m_amplitude);
+    }
+  for (unsigned int i = 0; i < m_oscillators.size (); i++)
+    {
+      PropagationSnapshot::WriteDouble (os, m_oscillators[i].m_amplitude.real ());
+      PropagationSnapshot::WriteDouble (os, m_oscillators[i].m_amplitude.imag ());
+      PropagationSnapshot::WriteDouble (os, m_oscillators[i].m_phase);
+      PropagationSnapshot::WriteDouble (os, m_oscillators[i].m_omega);
+    }
+  PropagationSnapshot::WriteU32 (os, m_nTxAntennas);
+  PropagationSnapshot::WriteU32 (os, m_nRxAntennas);
+  PropagationSnapshot::WriteDouble (os, m_txCorrelation);
+  PropagationSnapshot::WriteDouble (os, m_rxCorrelation);
+  PropagationSnapshot::WriteU32 (os, m_elementRotations.size ());
+  for (unsigned int i = 0; i < m_elementRotations.size (); i++)
+    {
+      PropagationSnapshot::WriteDouble (os, m_elementRotations[i].real ());
+      PropagationSnapshot::WriteDouble (os, m_elementRotations[i].imag ());
+    }
+  PropagationSnapshot::WriteU32 (os, m_hasLastGain);
+  PropagationSnapshot::WriteU64 (os, m_lastGainTime.GetTimeStep ());
+  PropagationSnapshot::WriteDouble (os, m_lastGainDb);
+}
+
+void
+JakesProcess::Deserialize (std::istream &is, Ptr<const PropagationLossModel> propagationModel)
+{
+  Ptr<const JakesPropagationLossModel> jakes = propagationModel->GetObject<JakesPropagationLossModel> ();
+  NS_ASSERT_MSG (jakes != 0, "Jakes Process can work only with JakesPropagationLossModel!");
+  m_jakes = jakes;
+  m_oscillators.clear ();
+  m_taps.clear ();
+  m_elementRotations.clear ();
+  m_omegaDopplerMax = PropagationSnapshot::ReadDouble (is);
+  m_nOscillators = PropagationSnapshot::ReadU32 (is);
+  uint32_t nTaps = PropagationSnapshot::ReadU32 (is);
+  for (uint32_t l = 0; l < nTaps; l++)
+    {
+      Tap tap;
+      tap.m_delay = PropagationSnapshot::ReadDouble (is);
+      tap.m_amplitude = PropagationSnapshot::ReadDouble (is);
+      tap.m_first = l * m_nOscillators;
+      m_taps.push_back (tap);
+    }
+  for (uint32_t i = 0; i < nTaps * m_nOscillators; i++)
+    {
+      double re = PropagationSnapshot::ReadDouble (is);
+      double im = PropagationSnapshot::ReadDouble (is);
+      double phase = PropagationSnapshot::ReadDouble (is);
+      double omega = PropagationSnapshot::ReadDouble (is);
+      m_oscillators.push_back (Oscillator (std::complex<double> (re, im), phase, omega));
+    }
+  m_nTxAntennas = PropagationSnapshot::ReadU32 (is);
+  m_nRxAntennas = PropagationSnapshot::ReadU32 (is);
+  m_txCorrelation = PropagationSnapshot::ReadDouble (is);
+  m_rxCorrelation = PropagationSnapshot::ReadDouble (is);
+  uint32_t nRotations = PropagationSnapshot::ReadU32 (is);
+  for (uint32_t i = 0; i < nRotations; i++)
+    {
+      double re = PropagationSnapshot::ReadDouble (is);
+      double im = PropagationSnapshot::ReadDouble (is);
+      m_elementRotations.push_back (std::complex<double> (re, im));
+    }
+  m_rxLower.clear ();
+  m_txLower.clear ();
+  if (m_rxCorrelation > 0)
+    {
+      GetExponentialCorrelationFactor (m_nRxAntennas, m_rxCorrelation, m_rxLower);
+    }
+  if (m_txCorrelation > 0)
+    {
+      GetExponentialCorrelationFactor (m_nTxAntennas, m_txCorrelation, m_txLower);
+    }
+  m_hasLastGain = PropagationSnapshot::ReadU32 (is);
+  m_lastGainTime = TimeStep (PropagationSnapshot::ReadU64 (is));
+  m_lastGainDb = PropagationSnapshot::ReadDouble (is);
 }
 
 void
@@ -92,35 +197,101 @@ void
 JakesProcess::ConstructOscillators ()
 {
   NS_ASSERT (m_jakes);
-  // Initial phase is common for all oscillators:
-  double phi = m_jakes->GetUniformRandomVariable ()->GetValue ();
-  // Theta is common for all oscillatoer:
-  double theta = m_jakes->GetUniformRandomVariable ()->GetValue ();
-  for (unsigned int i = 0; i < m_nOscillators; i++)
-    {
-      unsigned int n = i + 1;
-      /// 1. Rotation speed
-      /// 1a. Initiate \f[ \alpha_n = \frac{2\pi n - \pi + \theta}{4M},  n=1,2, \ldots,M\f], n is oscillatorNumber, M is m_nOscillators
-      double alpha = (2.0 * JakesPropagationLossModel::PI * n - JakesPropagationLossModel::PI + theta) / (4.0 * m_nOscillators);
-      /// 1b. Initiate rotation speed:
-      double omega = m_omegaDopplerMax * std::cos (alpha);
-      /// 2. Initiate complex amplitude:
-      double psi = m_jakes->GetUniformRandomVariable ()->GetValue ();
-      std::complex<double> amplitude = std::complex<double> (std::cos (psi), std::sin (psi)) * 2.0 / std::sqrt (m_nOscillators);
-      /// 3. Construct oscillator:
-      m_oscillators.push_back (Oscillator (amplitude, phi, omega)); 
+  const std::vector<double> &delays = m_jakes->m_tapDelays;
+  const std::vector<double> &amplitudes = m_jakes->m_tapAmplitudes;
+  NS_ASSERT (delays.size () == amplitudes.size () && !delays.empty ());
+  for (unsigned int l = 0; l < delays.size (); l++)
+    {
+      Tap tap;
+      tap.m_delay = delays[l];
+      tap.m_amplitude = amplitudes[l];
+      tap.m_first = m_oscillators.size ();
+      m_taps.push_back (tap);
+      // Initial phase is common for all oscillators of a tap:
+      double phi = m_jakes->DrawUniform ();
+      // Theta is common for all oscillatoer of a tap:
+      double theta = m_jakes->DrawUniform ();
+      for (unsigned int i = 0; i < m_nOscillators; i++)
+        {
+          unsigned int n = i + 1;
+          /// 1. Rotation speed
+          /// 1a. Initiate \f[ \alpha_n = \frac{2\pi n - \pi + \theta}{4M},  n=1,2, \ldots,M\f], n is oscillatorNumber, M is m_nOscillators
+          double alpha = (2.0 * JakesPropagationLossModel::PI * n - JakesPropagationLossModel::PI + theta) / (4.0 * m_nOscillators);
+          /// 1b. Initiate rotation speed:
+          double omega = m_omegaDopplerMax * std::cos (alpha);
+          /// 2. Initiate complex amplitude:
+          double psi = m_jakes->DrawUniform ();
+          std::complex<double> amplitude = std::complex<double> (std::cos (psi), std::sin (psi)) * 2.0 / std::sqrt (m_nOscillators);
+          /// 3. Construct oscillator:
+          m_oscillators.push_back (Oscillator (amplitude, phi, omega)); 
+        }
+    }
+}
+
+void
+JakesProcess::ConstructAntennas ()
+{
+  const uint32_t pairs = m_nTxAntennas * m_nRxAntennas;
+  if (pairs == 1)
+    {
+      // the single antenna case draws nothing more
+      return;
+    }
+  // drawn after all oscillators, so that the first element does not
+  // depend on the number of antennas
+  m_elementRotations.reserve (m_oscillators.size () * pairs);
+  for (unsigned int i = 0; i < m_oscillators.size (); i++)
+    {
+      m_elementRotations.push_back (std::complex<double> (1, 0));
+      for (uint32_t e = 1; e < pairs; e++)
+        {
+          double zeta = m_jakes->DrawUniform ();
+          m_elementRotations.push_back (std::complex<double> (std::cos (zeta), std::sin (zeta)));
+        }
+    }
+  if (m_rxCorrelation > 0)
+    {
+      GetExponentialCorrelationFactor (m_nRxAntennas, m_rxCorrelation, m_rxLower);
+    }
+  if (m_txCorrelation > 0)
+    {
+      GetExponentialCorrelationFactor (m_nTxAntennas, m_txCorrelation, m_txLower);
+    }
+}
+
+void
+JakesProcess::GetExponentialCorrelationFactor (uint32_t n, double rho, std::vector<double> &lower)
+{
+  // closed form Cholesky factor of R_ij = rho^|i-j|:
+  // L_i0 = rho^i, L_ij = rho^(i-j) sqrt (1 - rho^2) for 0 < j <= i
+  lower.assign (n * n, 0);
+  double scale = std::sqrt (1 - rho * rho);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      for (uint32_t j = 0; j <= i; j++)
+        {
+          lower[i * n + j] = std::pow (rho, static_cast<double> (i - j)) * (j == 0 ? 1 : scale);
+        }
     }
 }
 
 JakesProcess::JakesProcess () :
   m_omegaDopplerMax (0),
-  m_nOscillators (0)
+  m_nOscillators (0),
+  m_nTxAntennas (1),
+  m_nRxAntennas (1),
+  m_txCorrelation (0),
+  m_rxCorrelation (0),
+  m_lastGainDb (0),
+  m_hasLastGain (false)
 {
 }
 
 JakesProcess::~JakesProcess()
 {
   m_oscillators.clear ();
+  m_taps.clear ();
+  m_elementRotations.clear ();
 }
 
 void
@@ -131,20 +302,175 @@ JakesProcess::DoDispose ()
 
 std::complex<double>
 JakesProcess::GetComplexGain () const
+{
+  return GetComplexGain (Now ());
+}
+
+std::complex<double>
+JakesProcess::GetTapGain (const Tap &tap, Time at) const
 {
   std::complex<double> sumAplitude = std::complex<double> (0, 0);
-  for (unsigned int i = 0; i < m_oscillators.size (); i++)
+  for (unsigned int i = tap.m_first; i < tap.m_first + m_nOscillators; i++)
     {
-      sumAplitude += m_oscillators[i].GetValueAt (Now ());
+      sumAplitude += m_oscillators[i].GetValueAt (at);
+    }
+  return sumAplitude * tap.m_amplitude;
+}
+
+std::complex<double>
+JakesProcess::GetComplexGain (Time at) const
+{
+  std::complex<double> sumAplitude = std::complex<double> (0, 0);
+  for (unsigned int l = 0; l < m_taps.size (); l++)
+    {
+      sumAplitude += GetTapGain (m_taps[l], at);
     }
   return sumAplitude;
 }
 
+void
+JakesProcess::GetFrequencyResponse (Time at, uint32_t nSubcarriers, double spacing,
+                                    std::vector<std::complex<double> > &out) const
+{
+  out.assign (nSubcarriers, std::complex<double> (0, 0));
+  double firstOffset = -0.5 * (static_cast<double> (nSubcarriers) - 1) * spacing;
+  for (unsigned int l = 0; l < m_taps.size (); l++)
+    {
+      std::complex<double> gain = GetTapGain (m_taps[l], at);
+      if (m_taps[l].m_delay == 0)
+        {
+          for (uint32_t k = 0; k < nSubcarriers; k++)
+            {
+              out[k] += gain;
+            }
+          continue;
+        }
+      double omegaTau = -2 * JakesPropagationLossModel::PI * m_taps[l].m_delay;
+      std::complex<double> rotation = std::polar (1.0, omegaTau * firstOffset);
+      std::complex<double> step = std::polar (1.0, omegaTau * spacing);
+      std::complex<double> value = gain * rotation;
+      for (uint32_t k = 0; k < nSubcarriers; k++)
+        {
+          out[k] += value;
+          value *= step;
+        }
+    }
+}
+
+void
+JakesProcess::GetChannelMatrix (Time at, std::vector<std::complex<double> > &out) const
+{
+  const uint32_t pairs = m_nTxAntennas * m_nRxAntennas;
+  if (pairs == 1)
+    {
+      out.assign (1, GetComplexGain (at));
+      return;
+    }
+  NS_ASSERT (m_elementRotations.size () == m_oscillators.size () * pairs);
+  m_white.assign (pairs, std::complex<double> (0, 0));
+  double t = at.GetSeconds ();
+  for (unsigned int l = 0; l < m_taps.size (); l++)
+    {
+      const Tap &tap = m_taps[l];
+      for (unsigned int i = tap.m_first; i < tap.m_first + m_nOscillators; i++)
+        {
+          const Oscillator &oscillator = m_oscillators[i];
+          // cos (x + zeta) = cos (x) cos (zeta) - sin (x) sin (zeta)
+          double x = t * oscillator.m_omega + oscillator.m_phase;
+          double c = std::cos (x);
+          double s = std::sin (x);
+          std::complex<double> amplitude = oscillator.m_amplitude * tap.m_amplitude;
+          const std::complex<double> *rotation = &m_elementRotations[i * pairs];
+          for (uint32_t e = 0; e < pairs; e++)
+            {
+              m_white[e] += amplitude * (c * rotation[e].real () - s * rotation[e].imag ());
+            }
+        }
+    }
+
+  // H = L_r W L_t^T, skipping the identity factors
+  out = m_white;
+  if (!m_rxLower.empty ())
+    {
+      for (uint32_t r = 0; r < m_nRxAntennas; r++)
+        {
+          for (uint32_t tx = 0; tx < m_nTxAntennas; tx++)
+            {
+              std::complex<double> sum (0, 0);
+              for (uint32_t k = 0; k <= r; k++)
+                {
+                  sum += m_rxLower[r * m_nRxAntennas + k] * m_white[k * m_nTxAntennas + tx];
+                }
+              out[r * m_nTxAntennas + tx] = sum;
+            }
+        }
+    }
+  if (!m_txLower.empty ())
+    {
+      m_white = out;
+      for (uint32_t r = 0; r < m_nRxAntennas; r++)
+        {
+          for (uint32_t tx = 0; tx < m_nTxAntennas; tx++)
+            {
+              std::complex<double> sum (0, 0);
+              for (uint32_t k = 0; k <= tx; k++)
+                {
+                  sum += m_white[r * m_nTxAntennas + k] * m_txLower[tx * m_nTxAntennas + k];
+                }
+              out[r * m_nTxAntennas + tx] = sum;
+            }
+        }
+    }
+}
+
+uint32_t
+JakesProcess::GetNTxAntennas () const
+{
+  return m_nTxAntennas;
+}
+
+uint32_t
+JakesProcess::GetNRxAntennas () const
+{
+  return m_nRxAntennas;
+}
+
 double
 JakesProcess::GetChannelGainDb () const
 {
-  std::complex<double> complexGain = GetComplexGain ();
+  return GetChannelGainDb (Now ());
+}
+
+double
+JakesProcess::GetChannelGainDb (Time at) const
+{
+  std::complex<double> complexGain = GetComplexGain (at);
   return (10 * std::log10 ((std::pow (complexGain.real (), 2) + std::pow (complexGain.imag (), 2)) / 2));
 }
 
+double
+JakesProcess::GetChannelGainDb (Time at, double coherenceFraction, bool &reused) const
+{
+  reused = false;
+  if (m_hasLastGain && at >= m_lastGainTime)
+    {
+      // elapsed * f_d < fraction, with f_d = omega / (2 pi)
+      double elapsed = (at - m_lastGainTime).GetSeconds ();
+      reused = (elapsed * m_omegaDopplerMax < coherenceFraction * 2 * JakesPropagationLossModel::PI);
+    }
+  if (!reused)
+    {
+      m_lastGainDb = GetChannelGainDb (at);
+      m_lastGainTime = at;
+      m_hasLastGain = true;
+    }
+  return m_lastGainDb;
+}
+
+double
+JakesProcess::GetDopplerFrequencyHz () const
+{
+  return m_omegaDopplerMax / (2 * JakesPropagationLossModel::PI);
+}
+
 } // namespace ns3
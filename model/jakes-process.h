@@ -24,6 +24,8 @@
 #include "ns3/nstime.h"
 #include "ns3/random-variable-stream.h"
 #include <complex>
+#include <vector>
+#include <iostream>
 
 namespace ns3
 {
@@ -47,6 +49,24 @@ class JakesPropagationLossModel;
  * where
  *\f$\theta\f$, \f$\phi\f$, and \f$\psi_n\f$ are statically independent and uniformly distributed over \f$[-\pi, \pi)\f$ for all \f$n\f$.
  *
+ * If the JakesPropagationLossModel has a power delay profile with several
+ * taps, every tap \f$l\f$ gets its own independent set of oscillators
+ * \f$X_l(t)\f$, scaled by the square root of its normalized power
+ * \f$p_l\f$, and the frequency response at offset \f$f\f$ from the
+ * carrier is
+ * \f[ H(t, f) = \sum_l \sqrt{p_l} X_l(t) e^{-j 2 \pi f \tau_l} \f]
+ * The narrowband gain is the response at the carrier, \f$H(t, 0)\f$.
+ *
+ * With several transmit or receive antennas, every antenna pair
+ * \f$e = (r, t)\f$ reuses the same oscillators, shifted by its own random
+ * phase \f$\zeta_{n,e}\f$ drawn once per oscillator:
+ * \f[ W_e(t) = \sum_l \sqrt{p_l} \sum_n a_n \cos(\omega_n t + \phi_l + \zeta_{n,e}) \f]
+ * with \f$\zeta_{n,0} = 0\f$, so that the first element is the single
+ * antenna gain. The pairs are uncorrelated; the optional exponential
+ * correlation \f$R_{ij} = \rho^{|i - j|}\f$ at either end is applied with
+ * the Kronecker model \f$ H = L_r W L_t^T \f$, \f$L\f$ being the Cholesky
+ * factor of \f$R\f$.
+ *
  *
  * [1] Y. R. Zheng and C. Xiao, "Simulation Models With Correct
  * Statistical Properties for Rayleigh Fading Channel", IEEE
@@ -60,9 +80,52 @@ public:
   virtual ~JakesProcess();
   virtual void DoDispose ();
   std::complex<double> GetComplexGain () const;
+  /// Get the complex gain at moment \param at
+  std::complex<double> GetComplexGain (Time at) const;
   /// Get Channel gain [dB]
   double GetChannelGainDb () const;
+  /// Get Channel gain [dB] at moment \param at
+  double GetChannelGainDb (Time at) const;
+  /**
+   * \brief Get Channel gain [dB] at moment \param at, or the last computed gain
+   * if it is younger than a fraction of the coherence time \f$1/f_d\f$
+   * \param coherenceFraction the fraction of \f$1/f_d\f$ during which a gain is reused
+   * \param reused set to true if the last gain was returned
+   */
+  double GetChannelGainDb (Time at, double coherenceFraction, bool &reused) const;
+  /// \returns the maximum Doppler frequency [Hz]
+  double GetDopplerFrequencyHz () const;
+  /**
+   * \brief Evaluate the frequency response of all subcarriers at moment \param at
+   * \param nSubcarriers the number of subcarriers
+   * \param spacing the subcarrier spacing [Hz]
+   * \param out resized to nSubcarriers; element k receives \f$H(t, f_k)\f$ with
+   * \f$f_k = (k - (nSubcarriers - 1) / 2) \cdot spacing\f$, normalized like GetComplexGain
+   *
+   * The oscillators of every tap are summed once, then the per-subcarrier
+   * phase rotation of each tap is obtained by recursive multiplication,
+   * so no trigonometric function is evaluated per subcarrier.
+   */
+  void GetFrequencyResponse (Time at, uint32_t nSubcarriers, double spacing,
+                             std::vector<std::complex<double> > &out) const;
+  /**
+   * \brief Evaluate the narrowband channel matrix at moment \param at
+   * \param out resized to NumberOfRxAntennas * NumberOfTxAntennas; element
+   * \f$r \cdot N_t + t\f$ receives the gain from transmit antenna t to receive
+   * antenna r, normalized like GetComplexGain
+   *
+   * The cosine and sine of every oscillator are computed once; each
+   * antenna pair then only costs a multiply-add with its precomputed
+   * phase rotation.
+   */
+  void GetChannelMatrix (Time at, std::vector<std::complex<double> > &out) const;
+  uint32_t GetNTxAntennas () const;
+  uint32_t GetNRxAntennas () const;
   void SetPropagationLossModel (Ptr<const PropagationLossModel>);
+  /// Save the oscillators and antenna phases, see PropagationLossModel::Serialize
+  void Serialize (std::ostream &os) const;
+  /// Restore the state saved by Serialize instead of drawing new oscillators
+  void Deserialize (std::istream &is, Ptr<const PropagationLossModel> propagationModel);
 private:
   /// Represents a single oscillator
   struct Oscillator
@@ -78,20 +141,50 @@ private:
     /// Rotation speed of the oscillator \f[\omega_d \cos(\alpha_n)]
     double m_omega;
   };
+  /// A tap of the power delay profile and its oscillators
+  struct Tap
+  {
+    /// Delay \f[\tau_l] [s]
+    double m_delay;
+    /// Square root of the normalized tap power
+    double m_amplitude;
+    /// Index of the first oscillator of this tap in m_oscillators
+    unsigned int m_first;
+  };
+  std::complex<double> GetTapGain (const Tap &tap, Time at) const;
 private:
   void SetNOscillators (unsigned int nOscillators);
   void SetDopplerFrequencyHz (double dopplerFrequencyHz);
   void ConstructOscillators ();
+  void ConstructAntennas ();
+  /// Cholesky factor of the n x n exponential correlation matrix, row major
+  static void GetExponentialCorrelationFactor (uint32_t n, double rho, std::vector<double> &lower);
 private:
-  /// Vector of oscillators:
+  /// Vector of oscillators, m_nOscillators for every tap:
   std::vector<Oscillator> m_oscillators;
+  std::vector<Tap> m_taps;
   ///\name Attributes:
   ///\{
   double m_omegaDopplerMax;
   unsigned int m_nOscillators;
   Ptr<UniformRandomVariable> m_uniformVariable;
   Ptr<const JakesPropagationLossModel> m_jakes;
+  uint32_t m_nTxAntennas;
+  uint32_t m_nRxAntennas;
+  double m_txCorrelation;
+  double m_rxCorrelation;
   ///\}
+  /// \f$e^{j \zeta_{n,e}}\f$ of oscillator n and antenna pair e, at n * pairs + e
+  std::vector<std::complex<double> > m_elementRotations;
+  /// Cholesky factors of the receive and transmit correlation, empty if uncorrelated
+  std::vector<double> m_rxLower;
+  std::vector<double> m_txLower;
+  /// Uncorrelated matrix of the last GetChannelMatrix
+  mutable std::vector<std::complex<double> > m_white;
+  /// Time and value of the last gain returned by the reusing GetChannelGainDb
+  mutable Time m_lastGainTime;
+  mutable double m_lastGainDb;
+  mutable bool m_hasLastGain;
 };
 } // namespace ns3
 #endif // DOPPLER_PROCESS_H
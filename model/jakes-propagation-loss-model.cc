@@ -20,7 +20,14 @@
 
 #include "jakes-propagation-loss-model.h"
 #include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/enum.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/abort.h"
+#include <cmath>
+#include <limits>
 
 NS_LOG_COMPONENT_DEFINE ("Jakes");
 
@@ -31,11 +38,22 @@ NS_OBJECT_ENSURE_REGISTERED (JakesPropagationLossModel);
 
 const double JakesPropagationLossModel::PI = 3.14159265358979323846;
 
-JakesPropagationLossModel::JakesPropagationLossModel()
+JakesPropagationLossModel::JakesPropagationLossModel() :
+  m_engine (SumOfSinusoids),
+  m_coherenceFraction (0),
+  m_counterBased (false),
+  m_maxGainQuantile (0.9999),
+  m_computedGains (0),
+  m_reusedGains (0),
+  m_uniformDraws (0),
+  m_normalDraws (0)
 {
   m_uniformVariable = CreateObject<UniformRandomVariable> ();
   m_uniformVariable->SetAttribute ("Min", DoubleValue (-1.0 * PI));
   m_uniformVariable->SetAttribute ("Max", DoubleValue (PI));
+  m_normalVariable = CreateObject<NormalRandomVariable> ();
+  m_tapDelays.push_back (0);
+  m_tapAmplitudes.push_back (1);
 }
 
 JakesPropagationLossModel::~JakesPropagationLossModel()
@@ -47,6 +65,36 @@ JakesPropagationLossModel::GetTypeId ()
   static TypeId tid = TypeId ("ns3::JakesPropagationLossModel")
     .SetParent<PropagationLossModel> ()
     .AddConstructor<JakesPropagationLossModel> ()
+    .AddAttribute ("TraceFilename",
+                   "Precomputed fading trace shared by all links. Empty to compute the fading of every link.",
+                   StringValue (""),
+                   MakeStringAccessor (&JakesPropagationLossModel::SetTraceFilename,
+                                       &JakesPropagationLossModel::GetTraceFilename),
+                   MakeStringChecker ())
+    .AddAttribute ("CoherenceTimeFraction",
+                   "Fraction of the coherence time 1/f_d during which the last gain of a link is reused. "
+                   "0 computes a new gain on every call.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&JakesPropagationLossModel::m_coherenceFraction),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("FadingEngine",
+                   "The generator of the fading of a link. FilteredGaussian assigns a second "
+                   "stream, so set this before AssignStreams.",
+                   EnumValue (SumOfSinusoids),
+                   MakeEnumAccessor (&JakesPropagationLossModel::m_engine),
+                   MakeEnumChecker (SumOfSinusoids, "SumOfSinusoids",
+                                    FilteredGaussian, "FilteredGaussian"))
+    .AddAttribute ("CounterBasedStreams",
+                   "Draw the state of every link from its own counter-based sequence, "
+                   "independent of the order in which links are created.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&JakesPropagationLossModel::m_counterBased),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxGainQuantile",
+                   "Quantile of the gain reported by GetMaxGainDb, used to skip the model below a cutoff.",
+                   DoubleValue (0.9999),
+                   MakeDoubleAccessor (&JakesPropagationLossModel::m_maxGainQuantile),
+                   MakeDoubleChecker<double> (0.0, 1.0))
   ;
   return tid;
 }
@@ -55,29 +103,292 @@ double
 JakesPropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                           Ptr<MobilityModel> a,
                                           Ptr<MobilityModel> b) const
+{
+  if (m_trace != 0)
+    {
+      double *offset = m_traceOffsets.GetPathData (a, b, 0);
+      if (offset == 0)
+        {
+          SeekLink (a, b);
+          // map U[-pi, pi) to a start time within the trace
+          double u = (DrawUniform () + PI) / (2 * PI);
+          offset = &m_traceOffsets.AddPathData (u * m_trace->GetDuration (), a, b, 0);
+        }
+      return txPowerDbm + m_trace->GetChannelGainDb (GetEvaluationTime ().GetSeconds () + *offset);
+    }
+  if (m_engine == FilteredGaussian)
+    {
+      Ptr<FilteredGaussianFadingProcess> process = m_filteredCache.GetPathData (a, b, 0);
+      if (process == 0)
+        {
+          SeekLink (a, b);
+          process = CreateObject<FilteredGaussianFadingProcess> ();
+          process->SetPropagationLossModel (this);
+          m_filteredCache.AddPathData (process, a, b, 0);
+        }
+      m_computedGains++;
+      return txPowerDbm + process->GetChannelGainDb (GetEvaluationTime ());
+    }
+  Ptr<JakesProcess> pathData = GetPathData (a, b);
+  if (m_coherenceFraction > 0)
+    {
+      bool reused;
+      double gainDb = pathData->GetChannelGainDb (GetEvaluationTime (), m_coherenceFraction, reused);
+      if (reused)
+        {
+          m_reusedGains++;
+        }
+      else
+        {
+          m_computedGains++;
+        }
+      return txPowerDbm + gainDb;
+    }
+  m_computedGains++;
+  return txPowerDbm + pathData->GetChannelGainDb (GetEvaluationTime ());
+}
+
+Ptr<JakesProcess>
+JakesPropagationLossModel::GetPathData (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
 {
   Ptr<JakesProcess> pathData = m_propagationCache.GetPathData (a, b, 0 /**Spectrum model uid is not used in PropagationLossModel*/);
   if (pathData == 0)
     {
+      SeekLink (a, b);
       pathData = CreateObject<JakesProcess> ();
       pathData->SetPropagationLossModel (this);
       m_propagationCache.AddPathData (pathData, a, b, 0/**Spectrum model uid is not used in PropagationLossModel*/);
     }
-  return txPowerDbm + pathData->GetChannelGainDb ();
+  return pathData;
+}
+
+void
+JakesPropagationLossModel::SetPowerDelayProfile (const std::vector<double> &delays, const std::vector<double> &powersDb)
+{
+  NS_ABORT_MSG_IF (delays.empty () || delays.size () != powersDb.size (),
+                   "A power delay profile needs one power per tap delay");
+  double totalPower = 0;
+  for (unsigned int l = 0; l < powersDb.size (); l++)
+    {
+      totalPower += std::pow (10, powersDb[l] / 10);
+    }
+  m_tapDelays = delays;
+  m_tapAmplitudes.clear ();
+  for (unsigned int l = 0; l < powersDb.size (); l++)
+    {
+      NS_ABORT_MSG_IF (delays[l] < 0, "Tap delays must not be negative");
+      m_tapAmplitudes.push_back (std::sqrt (std::pow (10, powersDb[l] / 10) / totalPower));
+    }
+}
+
+void
+JakesPropagationLossModel::GetFrequencyResponse (Ptr<MobilityModel> a, Ptr<MobilityModel> b,
+                                                 uint32_t nSubcarriers, double spacing,
+                                                 std::vector<std::complex<double> > &out) const
+{
+  NS_ABORT_MSG_IF (m_trace != 0, "A fading trace has no frequency response");
+  NS_ABORT_MSG_IF (m_engine == FilteredGaussian, "The FilteredGaussian engine has no frequency response");
+  GetPathData (a, b)->GetFrequencyResponse (Now (), nSubcarriers, spacing, out);
+}
+
+void
+JakesPropagationLossModel::GetChannelMatrix (Ptr<MobilityModel> a, Ptr<MobilityModel> b,
+                                             std::vector<std::complex<double> > &out) const
+{
+  NS_ABORT_MSG_IF (m_trace != 0, "A fading trace has no channel matrix");
+  NS_ABORT_MSG_IF (m_engine == FilteredGaussian, "The FilteredGaussian engine has no channel matrix");
+  GetPathData (a, b)->GetChannelMatrix (Now (), out);
+}
+
+void
+JakesPropagationLossModel::SetTraceFilename (std::string filename)
+{
+  m_traceFilename = filename;
+  m_traceOffsets.Clear ();
+  if (filename.empty ())
+    {
+      m_trace = 0;
+      return;
+    }
+  m_trace = Create<JakesFadingTrace> ();
+  m_trace->Open (filename);
+}
+
+std::string
+JakesPropagationLossModel::GetTraceFilename (void) const
+{
+  return m_traceFilename;
+}
+
+uint64_t
+JakesPropagationLossModel::GetNumberOfComputedGains (void) const
+{
+  return m_computedGains;
+}
+
+uint64_t
+JakesPropagationLossModel::GetNumberOfReusedGains (void) const
+{
+  return m_reusedGains;
+}
+
+double
+JakesPropagationLossModel::GetGainReuseRatio (void) const
+{
+  uint64_t total = m_computedGains + m_reusedGains;
+  if (total == 0)
+    {
+      return 0;
+    }
+  return static_cast<double> (m_reusedGains) / total;
+}
+
+void
+JakesPropagationLossModel::ResetGainStatistics (void)
+{
+  m_computedGains = 0;
+  m_reusedGains = 0;
+}
+
+void
+JakesPropagationLossModel::SeekLink (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  if (m_counterBased)
+    {
+      // a link draws its state once, from the start of its sequence
+      m_rng.Seek (a, b, 0);
+    }
+}
+
+uint64_t
+JakesPropagationLossModel::GetNLinks (void) const
+{
+  return static_cast<uint64_t> (m_propagationCache.GetSize ()) + m_filteredCache.GetSize ()
+         + m_traceOffsets.GetN () + m_rng.GetNLinks ();
+}
+
+double
+JakesPropagationLossModel::GetMaxGainDb (void) const
+{
+  if (m_maxGainQuantile >= 1)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  // the power gain of Rayleigh fading is exponential with unit mean
+  return 10 * std::log10 (-std::log (1 - m_maxGainQuantile));
 }
 
-Ptr<UniformRandomVariable>
-JakesPropagationLossModel::GetUniformRandomVariable () const
+double
+JakesPropagationLossModel::DrawUniform () const
+{
+  if (m_counterBased)
+    {
+      return -PI + 2 * PI * m_rng.GetUniform ();
+    }
+  m_uniformDraws++;
+  return m_uniformVariable->GetValue ();
+}
+
+double
+JakesPropagationLossModel::DrawNormal () const
 {
-  return m_uniformVariable;
+  if (m_counterBased)
+    {
+      return m_rng.GetNormal ();
+    }
+  m_normalDraws++;
+  return m_normalVariable->GetValue ();
 }
 
 int64_t
 JakesPropagationLossModel::DoAssignStreams (int64_t stream)
 {
   m_uniformVariable->SetStream (stream);
-  return 1;
+  m_rng.SetStream (stream);
+  if (m_engine != FilteredGaussian)
+    {
+      // the Gaussian variable only serves the filtered engine: the models
+      // chained after this one keep their streams
+      return 1;
+    }
+  m_normalVariable->SetStream (stream + 1);
+  return 2;
 }
 
-} // namespace ns3
+void
+JakesPropagationLossModel::DoSerialize (std::ostream &os) const
+{
+  PropagationSnapshot::WriteU64 (os, m_uniformDraws);
+  PropagationSnapshot::WriteU64 (os, m_normalDraws);
+  PropagationSnapshot::WriteU64 (os, m_computedGains);
+  PropagationSnapshot::WriteU64 (os, m_reusedGains);
+  PropagationSnapshot::WriteU32 (os, m_propagationCache.GetSize ());
+  for (PropagationCache<JakesProcess>::Iterator it = m_propagationCache.Begin (); it != m_propagationCache.End (); ++it)
+    {
+      PropagationSnapshot::WriteMobility (os, it->first.m_srcMobility);
+      PropagationSnapshot::WriteMobility (os, it->first.m_dstMobility);
+      it->second->Serialize (os);
+    }
+  PropagationSnapshot::WriteU32 (os, m_filteredCache.GetSize ());
+  for (PropagationCache<FilteredGaussianFadingProcess>::Iterator it = m_filteredCache.Begin (); it != m_filteredCache.End (); ++it)
+    {
+      PropagationSnapshot::WriteMobility (os, it->first.m_srcMobility);
+      PropagationSnapshot::WriteMobility (os, it->first.m_dstMobility);
+      it->second->Serialize (os);
+    }
+  PropagationSnapshot::WriteU32 (os, m_traceOffsets.GetN ());
+  for (PropagationArena<double>::Iterator it = m_traceOffsets.Begin (); it != m_traceOffsets.End (); ++it)
+    {
+      PropagationSnapshot::WriteMobility (os, it->first.m_srcMobility);
+      PropagationSnapshot::WriteMobility (os, it->first.m_dstMobility);
+      PropagationSnapshot::WriteDouble (os, m_traceOffsets.Get (it->second));
+    }
+}
 
+void
+JakesPropagationLossModel::DoDeserialize (std::istream &is)
+{
+  NS_ABORT_MSG_IF (m_uniformDraws != 0 || m_normalDraws != 0,
+                   "A snapshot can only be restored into an unused JakesPropagationLossModel");
+  // move the streams to the position they had when the snapshot was taken
+  uint64_t uniformDraws = PropagationSnapshot::ReadU64 (is);
+  uint64_t normalDraws = PropagationSnapshot::ReadU64 (is);
+  while (m_uniformDraws < uniformDraws)
+    {
+      DrawUniform ();
+    }
+  while (m_normalDraws < normalDraws)
+    {
+      DrawNormal ();
+    }
+  m_computedGains = PropagationSnapshot::ReadU64 (is);
+  m_reusedGains = PropagationSnapshot::ReadU64 (is);
+
+  uint32_t n = PropagationSnapshot::ReadU32 (is);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<MobilityModel> a = PropagationSnapshot::ReadMobility (is);
+      Ptr<MobilityModel> b = PropagationSnapshot::ReadMobility (is);
+      Ptr<JakesProcess> process = CreateObject<JakesProcess> ();
+      process->Deserialize (is, this);
+      m_propagationCache.AddPathData (process, a, b, 0);
+    }
+  n = PropagationSnapshot::ReadU32 (is);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<MobilityModel> a = PropagationSnapshot::ReadMobility (is);
+      Ptr<MobilityModel> b = PropagationSnapshot::ReadMobility (is);
+      Ptr<FilteredGaussianFadingProcess> process = CreateObject<FilteredGaussianFadingProcess> ();
+      process->Deserialize (is, this);
+      m_filteredCache.AddPathData (process, a, b, 0);
+    }
+  n = PropagationSnapshot::ReadU32 (is);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<MobilityModel> a = PropagationSnapshot::ReadMobility (is);
+      Ptr<MobilityModel> b = PropagationSnapshot::ReadMobility (is);
+      m_traceOffsets.AddPathData (PropagationSnapshot::ReadDouble (is), a, b, 0);
+    }
+}
+
+} // namespace ns3
@@ -23,6 +23,9 @@
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-cache.h"
 #include "ns3/jakes-process.h"
+#include "ns3/jakes-fading-trace.h"
+#include "ns3/filtered-gaussian-fading-process.h"
+#include "ns3/counter-based-rng.h"
 
 namespace ns3
 {
@@ -31,6 +34,20 @@ namespace ns3
  *
  * \brief a  jakes narrowband propagation model.
  * Symmetrical cache for JakesProcess
+ *
+ * When the TraceFilename attribute names a fading trace (see
+ * JakesFadingTrace), no JakesProcess is built: every link reads the
+ * shared trace starting at its own random time offset.
+ *
+ * Setting the CoherenceTimeFraction attribute to a positive value lets a
+ * link reuse its last gain for that fraction of the coherence time
+ * \f$1/f_d\f$, which avoids most sums of sinusoids when packets on a
+ * link are much closer than the coherence time.
+ *
+ * With CounterBasedStreams, the oscillators (or Gaussian variates, or
+ * trace offset) of a link are drawn from the sequence of that link in a
+ * CounterBasedRng on the first assigned stream, so that they do not
+ * depend on the order in which links are first used.
  */
 
 class JakesPropagationLossModel : public PropagationLossModel
@@ -42,17 +59,108 @@ public:
   
   static const double PI;
 
+  /// The generator of the fading of a link
+  enum FadingEngine
+  {
+    SumOfSinusoids, FilteredGaussian
+  };
+
+  /**
+   * \param filename a fading trace written by JakesFadingTrace::Write,
+   * or an empty string to compute the sum of sinusoids for every link
+   */
+  void SetTraceFilename (std::string filename);
+  std::string GetTraceFilename (void) const;
+
+  /**
+   * \brief Make the fading frequency selective
+   * \param delays the delay of every tap [s]
+   * \param powersDb the relative power of every tap [dB], normalized to a total of 0 dB
+   *
+   * Every tap gets an independent set of NumberOfOscillators oscillators.
+   * The profile applies to links created after the call; the default is a
+   * single tap with no delay, i.e. flat fading.
+   */
+  void SetPowerDelayProfile (const std::vector<double> &delays, const std::vector<double> &powersDb);
+
+  /**
+   * \brief Frequency response of the link a<-->b at the current time
+   * \param a the mobility model of the source
+   * \param b the mobility model of the destination
+   * \param nSubcarriers the number of subcarriers
+   * \param spacing the subcarrier spacing [Hz]
+   * \param out the complex gain of every subcarrier, see JakesProcess::GetFrequencyResponse
+   */
+  void GetFrequencyResponse (Ptr<MobilityModel> a, Ptr<MobilityModel> b,
+                             uint32_t nSubcarriers, double spacing,
+                             std::vector<std::complex<double> > &out) const;
+
+  /**
+   * \brief Channel matrix of the link a<-->b at the current time
+   * \param a the mobility model of the source
+   * \param b the mobility model of the destination
+   * \param out the gains of every antenna pair, see JakesProcess::GetChannelMatrix
+   *
+   * The matrix size is set by the NumberOfTxAntennas and NumberOfRxAntennas
+   * attributes of JakesProcess. The link is symmetric: a and b may be
+   * swapped, and the matrix stays the same.
+   */
+  void GetChannelMatrix (Ptr<MobilityModel> a, Ptr<MobilityModel> b,
+                         std::vector<std::complex<double> > &out) const;
+
+  /// \returns the number of gains computed from the oscillators since the last reset
+  uint64_t GetNumberOfComputedGains (void) const;
+  /// \returns the number of gains reused within the coherence window since the last reset
+  uint64_t GetNumberOfReusedGains (void) const;
+  /// \returns the fraction of calls served by a reused gain, 0 if there was no call
+  double GetGainReuseRatio (void) const;
+  /// Reset the gain reuse statistics
+  void ResetGainStatistics (void);
+
+  /// \returns the MaxGainQuantile quantile of the Rayleigh gain
+  virtual double GetMaxGainDb (void) const;
+  /// \returns the number of fading processes, trace offsets and link sequences
+  virtual uint64_t GetNLinks (void) const;
+
 private:
   friend class JakesProcess;
+  friend class FilteredGaussianFadingProcess;
   double DoCalcRxPower (double txPowerDbm,
                         Ptr<MobilityModel> a,
                         Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
-  Ptr<UniformRandomVariable> GetUniformRandomVariable () const;
+  virtual void DoSerialize (std::ostream &os) const;
+  virtual void DoDeserialize (std::istream &is);
+  /// With CounterBasedStreams, position m_rng on the sequence of the link a<-->b
+  void SeekLink (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+  /// \returns a value of m_uniformVariable, counting the draws for Serialize
+  double DrawUniform () const;
+  /// \returns a value of m_normalVariable, counting the draws for Serialize
+  double DrawNormal () const;
+  Ptr<JakesProcess> GetPathData (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
 
   Ptr<UniformRandomVariable> m_uniformVariable;
+  Ptr<NormalRandomVariable> m_normalVariable;
 private:
   mutable PropagationCache<JakesProcess> m_propagationCache;
+  FadingEngine m_engine;
+  mutable PropagationCache<FilteredGaussianFadingProcess> m_filteredCache;
+  std::string m_traceFilename;
+  Ptr<JakesFadingTrace> m_trace;
+  /// Time offset [s] of every link into m_trace
+  mutable PropagationArena<double> m_traceOffsets;
+  /// Power delay profile used by new JakesProcess
+  std::vector<double> m_tapDelays;
+  std::vector<double> m_tapAmplitudes;
+  /// Fraction of 1/f_d during which the gain of a link is reused, 0 to disable
+  double m_coherenceFraction;
+  bool m_counterBased;
+  mutable CounterBasedRng m_rng;
+  double m_maxGainQuantile;
+  mutable uint64_t m_computedGains;
+  mutable uint64_t m_reusedGains;
+  mutable uint64_t m_uniformDraws;
+  mutable uint64_t m_normalDraws;
 };
 
 } // namespace ns3
@@ -46,7 +46,7 @@ Kun2600MhzPropagationLossModel::GetTypeId (void)
 double
 Kun2600MhzPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
 {
-  double dist = a->GetDistanceFrom (b);  
+  double dist = GetDistance (a, b);  
   double loss = 36 + 26 * std::log10 (dist);
   return loss;
 }
@@ -22,9 +22,44 @@
 
 #include "ns3/mobility-model.h"
 #include <map>
+#include <vector>
 
 namespace ns3
 {
+/**
+ * \ingroup propagation
+ * \brief Identifies a propagation path.
+ *
+ * Propagation path a-->b and b-->a is the same thing. Propagation path is identified by
+ * a couple of MobilityModels and a spectrum model UID
+ */
+struct PropagationPathIdentifier
+{
+  PropagationPathIdentifier (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid) :
+    m_srcMobility (a), m_dstMobility (b), m_spectrumModelUid (modelUid)
+  {};
+  Ptr<const MobilityModel> m_srcMobility;
+  Ptr<const MobilityModel> m_dstMobility;
+  uint32_t m_spectrumModelUid;
+  bool operator < (const PropagationPathIdentifier & other) const
+  {
+    if (m_spectrumModelUid != other.m_spectrumModelUid)
+      {
+        return m_spectrumModelUid < other.m_spectrumModelUid;
+      }
+    /// Links are supposed to be symmetrical!
+    if (std::min (m_dstMobility, m_srcMobility) != std::min (other.m_dstMobility, other.m_srcMobility))
+      {
+        return std::min (m_dstMobility, m_srcMobility) < std::min (other.m_dstMobility, other.m_srcMobility);
+      }
+    if (std::max (m_dstMobility, m_srcMobility) != std::max (other.m_dstMobility, other.m_srcMobility))
+      {
+        return std::max (m_dstMobility, m_srcMobility) < std::max (other.m_dstMobility, other.m_srcMobility);
+      }
+    return false;
+  }
+};
+
 /**
  * \ingroup propagation
  * \brief Constructs a cache of objects, where each obect is responsible for a single propagation path loss calculations.
@@ -54,37 +89,107 @@ public:
     m_pathCache.insert (std::make_pair (key, data)); 
   };
 private:
-  /// Each path is identified by
-  struct PropagationPathIdentifier
+  typedef std::map<PropagationPathIdentifier, Ptr<T> > PathCache;
+public:
+  /// Iterates over (path, data) pairs
+  typedef typename PathCache::const_iterator Iterator;
+  Iterator Begin (void) const
   {
-    PropagationPathIdentifier (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid) :
-      m_srcMobility (a), m_dstMobility (b), m_spectrumModelUid (modelUid)
-    {};
-    Ptr<const MobilityModel> m_srcMobility;
-    Ptr<const MobilityModel> m_dstMobility;
-    uint32_t m_spectrumModelUid;
-    bool operator < (const PropagationPathIdentifier & other) const
-    {
-      if (m_spectrumModelUid != other.m_spectrumModelUid)
-        {
-          return m_spectrumModelUid < other.m_spectrumModelUid;
-        }
-      /// Links are supposed to be symmetrical!
-      if (std::min (m_dstMobility, m_srcMobility) != std::min (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::min (m_dstMobility, m_srcMobility) < std::min (other.m_dstMobility, other.m_srcMobility);
-        }
-      if (std::max (m_dstMobility, m_srcMobility) != std::max (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::max (m_dstMobility, m_srcMobility) < std::max (other.m_dstMobility, other.m_srcMobility);
-        }
-      return false;
-    }
+    return m_pathCache.begin ();
+  };
+  Iterator End (void) const
+  {
+    return m_pathCache.end ();
+  };
+  /// \returns the number of known paths
+  uint32_t GetSize (void) const
+  {
+    return m_pathCache.size ();
   };
-  typedef std::map<PropagationPathIdentifier, Ptr<T> > PathCache;
 private:
   PathCache m_pathCache;
 };
+
+/**
+ * \ingroup propagation
+ * \brief Per-path storage of plain values, keyed like PropagationCache.
+ *
+ * Where PropagationCache keeps one reference-counted object per path,
+ * PropagationArena keeps small value types packed in a single vector
+ * instead of one object each. A new path still allocates the std::map
+ * node of its index, and from time to time a larger vector; a known path
+ * allocates nothing. Each path gets a dense index in [0, GetN ()) in the
+ * order in which it was added.
+ *
+ * Pointers returned by GetPathData are invalidated by the next call to
+ * AddPathData.
+ */
+template<class T>
+class PropagationArena
+{
+public:
+  PropagationArena () {};
+  ~PropagationArena () {};
+  /// \returns the data of the path a<-->b, or 0 if the path is not known yet
+  T * GetPathData (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
+  {
+    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
+    typename PathIndex::const_iterator it = m_pathIndex.find (key);
+    if (it == m_pathIndex.end ())
+      {
+        return 0;
+      }
+    return &m_pathData[it->second];
+  };
+  /// \returns a reference to the stored copy of data
+  T & AddPathData (const T &data, Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
+  {
+    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
+    NS_ASSERT (m_pathIndex.find (key) == m_pathIndex.end ());
+    m_pathIndex.insert (std::make_pair (key, static_cast<uint32_t> (m_pathData.size ())));
+    m_pathData.push_back (data);
+    return m_pathData.back ();
+  };
+  /// \returns the number of known paths
+  uint32_t GetN (void) const
+  {
+    return m_pathData.size ();
+  };
+  /// \returns the data of the i-th added path
+  T & Get (uint32_t i)
+  {
+    NS_ASSERT (i < m_pathData.size ());
+    return m_pathData[i];
+  };
+  /// \returns the data of the i-th added path
+  const T & Get (uint32_t i) const
+  {
+    NS_ASSERT (i < m_pathData.size ());
+    return m_pathData[i];
+  };
+  /// Forget all paths
+  void Clear (void)
+  {
+    m_pathIndex.clear ();
+    m_pathData.clear ();
+  };
+private:
+  typedef std::map<PropagationPathIdentifier, uint32_t> PathIndex;
+public:
+  /// Iterates over (path, index) pairs, the index being suitable for Get
+  typedef typename PathIndex::const_iterator Iterator;
+  Iterator Begin (void) const
+  {
+    return m_pathIndex.begin ();
+  };
+  Iterator End (void) const
+  {
+    return m_pathIndex.end ();
+  };
+private:
+  PathIndex m_pathIndex;
+  std::vector<T> m_pathData;
+};
 } // namespace ns3
 
 #endif // PROPAGATION_CACHE_H_
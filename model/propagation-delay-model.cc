@@ -22,6 +22,7 @@
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include <cmath>
 
 namespace ns3 {
 
@@ -46,6 +47,12 @@ PropagationDelayModel::AssignStreams (int64_t stream)
   return DoAssignStreams (stream);
 }
 
+int64_t
+PropagationDelayModel::GetDelayTicks (const PropagationLinkGeometry &geometry) const
+{
+  return GetDelay (geometry.GetA (), geometry.GetB ()).GetTimeStep ();
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (RandomPropagationDelayModel);
@@ -94,26 +101,73 @@ ConstantSpeedPropagationDelayModel::GetTypeId (void)
     .AddConstructor<ConstantSpeedPropagationDelayModel> ()
     .AddAttribute ("Speed", "The speed (m/s)",
                    DoubleValue (300000000.0),
-                   MakeDoubleAccessor (&ConstantSpeedPropagationDelayModel::m_speed),
+                   MakeDoubleAccessor (&ConstantSpeedPropagationDelayModel::SetSpeed,
+                                       &ConstantSpeedPropagationDelayModel::GetSpeed),
                    MakeDoubleChecker<double> ())
   ;
   return tid;
 }
 
 ConstantSpeedPropagationDelayModel::ConstantSpeedPropagationDelayModel ()
+  : m_speed (300000000.0),
+    m_ticksPerMeter (0),
+    m_ticksGuard (0),
+    m_resolution (Time::LAST)
 {
 }
 Time
 ConstantSpeedPropagationDelayModel::GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
 {
-  double distance = a->GetDistanceFrom (b);
-  double seconds = distance / m_speed;
-  return Seconds (seconds);
+  return TimeStep (GetDistanceTicks (a->GetDistanceFrom (b)));
+}
+int64_t
+ConstantSpeedPropagationDelayModel::GetDelayTicks (const PropagationLinkGeometry &geometry) const
+{
+  return GetDistanceTicks (geometry.GetDistance ());
+}
+void
+ConstantSpeedPropagationDelayModel::GetDelayTicks (Ptr<MobilityModel> a,
+                                                   const std::vector<Ptr<MobilityModel> > &b,
+                                                   std::vector<int64_t> &ticks) const
+{
+  ticks.resize (b.size ());
+  for (uint32_t i = 0; i < b.size (); i++)
+    {
+      ticks[i] = GetDistanceTicks (a->GetDistanceFrom (b[i]));
+    }
+}
+int64_t
+ConstantSpeedPropagationDelayModel::GetDistanceTicks (double distance) const
+{
+  if (m_resolution != Time::GetResolution ())
+    {
+      m_resolution = Time::GetResolution ();
+      double ticksPerSecond = Seconds (1.0).GetTimeStep ();
+      m_ticksPerMeter = ticksPerSecond / m_speed;
+      // the fixed point conversion of Seconds keeps 64 bits of fraction
+      m_ticksGuard = ticksPerSecond * 1e-18;
+    }
+  // Seconds converts distance / speed to fixed point, multiplies it by the
+  // steps per second and rounds down. The cached product differs from that
+  // by a few ulps, so it gives the same step unless it lies next to a step
+  // boundary, where the exact conversion is used
+  double ticks = distance * m_ticksPerMeter;
+  if (ticks < 4503599627370496.0) // 2^52: the product has a fraction
+    {
+      double step = std::floor (ticks);
+      double guard = ticks * 1e-13 + m_ticksGuard;
+      if (ticks - step > guard && step + 1 - ticks > guard)
+        {
+          return static_cast<int64_t> (step);
+        }
+    }
+  return Seconds (distance / m_speed).GetTimeStep ();
 }
 void
 ConstantSpeedPropagationDelayModel::SetSpeed (double speed)
 {
   m_speed = speed;
+  m_resolution = Time::LAST;
 }
 double
 ConstantSpeedPropagationDelayModel::GetSpeed (void) const
@@ -24,6 +24,8 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/propagation-link-geometry.h"
+#include <vector>
 
 namespace ns3 {
 
@@ -48,6 +50,14 @@ public:
    * source and destination.
    */
   virtual Time GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const = 0;
+  /**
+   * \param geometry the link
+   * \returns the propagation delay, in time steps (see Time::GetTimeStep)
+   *
+   * Same as GetDelay, for callers that share the geometry of the link with
+   * a loss model. The default calls GetDelay.
+   */
+  virtual int64_t GetDelayTicks (const PropagationLinkGeometry &geometry) const;
   /**
    * If this delay model uses objects of type RandomVariableStream,
    * set the stream numbers to the integers starting with the offset
@@ -91,6 +101,12 @@ private:
  * \ingroup propagation
  *
  * \brief the propagation speed is constant
+ *
+ * The delay is computed in time steps from a number of steps per meter
+ * cached when the speed or the time resolution changes, which avoids the
+ * conversion of Seconds (double) for every link. The result is the same as
+ * Seconds (distance / speed): when the product falls within rounding error
+ * of a step boundary, the delay is computed with Seconds.
  */
 class ConstantSpeedPropagationDelayModel : public PropagationDelayModel
 {
@@ -102,6 +118,16 @@ public:
    */
   ConstantSpeedPropagationDelayModel ();
   virtual Time GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+  virtual int64_t GetDelayTicks (const PropagationLinkGeometry &geometry) const;
+  /**
+   * \param a the source
+   * \param b the destinations
+   * \param ticks receives the delay to b[i], in time steps, at index i; it
+   * is resized to the number of destinations
+   */
+  void GetDelayTicks (Ptr<MobilityModel> a,
+                      const std::vector<Ptr<MobilityModel> > &b,
+                      std::vector<int64_t> &ticks) const;
   /**
    * \param speed the new speed (m/s)
    */
@@ -112,7 +138,14 @@ public:
   double GetSpeed (void) const;
 private:
   virtual int64_t DoAssignStreams (int64_t stream);
+  /// \returns the delay over distance, in time steps
+  int64_t GetDistanceTicks (double distance) const;
   double m_speed;
+  /// Time steps per meter, and the time resolution it was computed for
+  mutable double m_ticksPerMeter;
+  /// The absolute rounding error of Seconds, in time steps
+  mutable double m_ticksGuard;
+  mutable Time::Unit m_resolution;
 };
 
 } // namespace ns3
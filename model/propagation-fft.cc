@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "propagation-fft.h"
+#include "ns3/assert.h"
+#include <cmath>
+#include <algorithm>
+
+namespace ns3 {
+
+bool
+PropagationFftIsPowerOfTwo (uint32_t n)
+{
+  return n != 0 && (n & (n - 1)) == 0;
+}
+
+void
+PropagationFft (std::vector<std::complex<double> > &data, bool inverse)
+{
+  const uint32_t n = data.size ();
+  NS_ASSERT_MSG (PropagationFftIsPowerOfTwo (n), "FFT size must be a power of two");
+
+  // bit reversal permutation
+  for (uint32_t i = 1, j = 0; i < n; i++)
+    {
+      uint32_t bit = n >> 1;
+      for (; j & bit; bit >>= 1)
+        {
+          j ^= bit;
+        }
+      j ^= bit;
+      if (i < j)
+        {
+          std::swap (data[i], data[j]);
+        }
+    }
+
+  // butterflies; the twiddle factors of a stage are obtained by recursive
+  // multiplication, which keeps the cost at one sin/cos pair per stage
+  const double pi = 3.14159265358979323846;
+  for (uint32_t length = 2; length <= n; length <<= 1)
+    {
+      double angle = 2 * pi / length * (inverse ? 1 : -1);
+      std::complex<double> step (std::cos (angle), std::sin (angle));
+      for (uint32_t start = 0; start < n; start += length)
+        {
+          std::complex<double> w (1, 0);
+          for (uint32_t k = 0; k < length / 2; k++)
+            {
+              std::complex<double> even = data[start + k];
+              std::complex<double> odd = data[start + k + length / 2] * w;
+              data[start + k] = even + odd;
+              data[start + k + length / 2] = even - odd;
+              w *= step;
+            }
+        }
+    }
+
+  if (inverse)
+    {
+      for (uint32_t i = 0; i < n; i++)
+        {
+          data[i] /= static_cast<double> (n);
+        }
+    }
+}
+
+void
+PropagationFft2d (std::vector<std::complex<double> > &data, uint32_t rows, uint32_t cols, bool inverse)
+{
+  NS_ASSERT (data.size () == static_cast<size_t> (rows) * cols);
+  std::vector<std::complex<double> > line (cols);
+  for (uint32_t r = 0; r < rows; r++)
+    {
+      std::copy (data.begin () + r * cols, data.begin () + (r + 1) * cols, line.begin ());
+      PropagationFft (line, inverse);
+      std::copy (line.begin (), line.end (), data.begin () + r * cols);
+    }
+  line.resize (rows);
+  for (uint32_t c = 0; c < cols; c++)
+    {
+      for (uint32_t r = 0; r < rows; r++)
+        {
+          line[r] = data[r * cols + c];
+        }
+      PropagationFft (line, inverse);
+      for (uint32_t r = 0; r < rows; r++)
+        {
+          data[r * cols + c] = line[r];
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,54 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PROPAGATION_FFT_H
+#define PROPAGATION_FFT_H
+
+#include <complex>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ *
+ * \brief In-place radix-2 fast Fourier transform.
+ *
+ * A small bundled FFT so that the propagation models which synthesize
+ * random processes in the frequency domain need no external library.
+ *
+ * \param data the sequence to transform; its size must be a power of two
+ * \param inverse false for \f$ X_k = \sum_n x_n e^{-j 2 \pi k n / N} \f$,
+ * true for \f$ x_n = \frac{1}{N} \sum_k X_k e^{j 2 \pi k n / N} \f$
+ */
+void PropagationFft (std::vector<std::complex<double> > &data, bool inverse);
+
+/**
+ * \ingroup propagation
+ *
+ * \brief In-place two-dimensional FFT of a row major rows x cols array.
+ *
+ * Both dimensions must be powers of two; the inverse is scaled by
+ * 1/(rows cols).
+ */
+void PropagationFft2d (std::vector<std::complex<double> > &data, uint32_t rows, uint32_t cols, bool inverse);
+
+/// \returns true if n is a power of two
+bool PropagationFftIsPowerOfTwo (uint32_t n);
+
+} // namespace ns3
+
+#endif /* PROPAGATION_FFT_H */
@@ -0,0 +1,46 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "propagation-link-geometry.h"
+
+namespace ns3 {
+
+PropagationLinkGeometry::PropagationLinkGeometry (Ptr<MobilityModel> a, Ptr<MobilityModel> b)
+  : m_a (a),
+    m_b (b),
+    m_distance (-1)
+{
+}
+
+Ptr<MobilityModel>
+PropagationLinkGeometry::GetA (void) const
+{
+  return m_a;
+}
+
+Ptr<MobilityModel>
+PropagationLinkGeometry::GetB (void) const
+{
+  return m_b;
+}
+
+bool
+PropagationLinkGeometry::IsLink (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  return (a == m_a && b == m_b) || (a == m_b && b == m_a);
+}
+
+} // namespace ns3
@@ -0,0 +1,72 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PROPAGATION_LINK_GEOMETRY_H
+#define PROPAGATION_LINK_GEOMETRY_H
+
+#include "ns3/ptr.h"
+#include "ns3/mobility-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ *
+ * \brief The geometry of a link, computed once for all the models
+ *
+ * The distance between the two ends is computed on the first call of
+ * GetDistance and reused by the later calls, so that a chain of loss
+ * models and a delay model evaluating the same link share one distance
+ * computation. The geometry is only valid as long as the nodes do not
+ * move: build one per evaluation.
+ */
+class PropagationLinkGeometry
+{
+public:
+  /**
+   * \param a the mobility model of the source
+   * \param b the mobility model of the destination
+   */
+  PropagationLinkGeometry (Ptr<MobilityModel> a, Ptr<MobilityModel> b);
+
+  /// \returns the mobility model of the source
+  Ptr<MobilityModel> GetA (void) const;
+  /// \returns the mobility model of the destination
+  Ptr<MobilityModel> GetB (void) const;
+  /// \returns true if this is the geometry of the link a<->b, in either direction
+  bool IsLink (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+  /// \returns the distance between the two ends (m)
+  inline double GetDistance (void) const;
+
+private:
+  Ptr<MobilityModel> m_a;
+  Ptr<MobilityModel> m_b;
+  /// The distance, negative until computed
+  mutable double m_distance;
+};
+
+double
+PropagationLinkGeometry::GetDistance (void) const
+{
+  if (m_distance < 0)
+    {
+      m_distance = m_a->GetDistanceFrom (m_b);
+    }
+  return m_distance;
+}
+
+} // namespace ns3
+
+#endif /* PROPAGATION_LINK_GEOMETRY_H */
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "propagation-link-state.h"
+#include "propagation-link-geometry.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/pointer.h"
+#include "ns3/mobility-model.h"
+
+NS_LOG_COMPONENT_DEFINE ("PropagationLinkStateEvaluator");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (PropagationLinkStateEvaluator);
+
+TypeId
+PropagationLinkStateEvaluator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PropagationLinkStateEvaluator")
+    .SetParent<Object> ()
+    .AddConstructor<PropagationLinkStateEvaluator> ()
+    .AddAttribute ("LossModel",
+                   "The propagation loss model (or chain) of the links.",
+                   PointerValue (),
+                   MakePointerAccessor (&PropagationLinkStateEvaluator::m_loss),
+                   MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("DelayModel",
+                   "The propagation delay model of the links.",
+                   PointerValue (),
+                   MakePointerAccessor (&PropagationLinkStateEvaluator::m_delay),
+                   MakePointerChecker<PropagationDelayModel> ())
+  ;
+  return tid;
+}
+
+PropagationLinkStateEvaluator::PropagationLinkStateEvaluator ()
+{
+}
+
+PropagationLinkStateEvaluator::~PropagationLinkStateEvaluator ()
+{
+}
+
+void
+PropagationLinkStateEvaluator::DoDispose (void)
+{
+  m_loss = 0;
+  m_delay = 0;
+  Object::DoDispose ();
+}
+
+void
+PropagationLinkStateEvaluator::SetLossModel (Ptr<PropagationLossModel> loss)
+{
+  m_loss = loss;
+}
+
+Ptr<PropagationLossModel>
+PropagationLinkStateEvaluator::GetLossModel (void) const
+{
+  return m_loss;
+}
+
+void
+PropagationLinkStateEvaluator::SetDelayModel (Ptr<PropagationDelayModel> delay)
+{
+  m_delay = delay;
+}
+
+Ptr<PropagationDelayModel>
+PropagationLinkStateEvaluator::GetDelayModel (void) const
+{
+  return m_delay;
+}
+
+PropagationLinkState
+PropagationLinkStateEvaluator::Evaluate (double txPowerDbm,
+                                         Ptr<MobilityModel> a,
+                                         Ptr<MobilityModel> b) const
+{
+  NS_ASSERT_MSG (m_loss != 0 && m_delay != 0, "Set the loss and delay models first");
+  PropagationLinkGeometry geometry (a, b);
+  PropagationLinkState state;
+  state.m_delayTicks = m_delay->GetDelayTicks (geometry);
+  state.m_rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, geometry);
+  return state;
+}
+
+void
+PropagationLinkStateEvaluator::Evaluate (double txPowerDbm,
+                                         Ptr<MobilityModel> tx,
+                                         const std::vector<Ptr<MobilityModel> > &rx,
+                                         std::vector<PropagationLinkState> &states) const
+{
+  NS_ASSERT_MSG (m_loss != 0 && m_delay != 0, "Set the loss and delay models first");
+  states.resize (rx.size ());
+  for (uint32_t i = 0; i < rx.size (); i++)
+    {
+      PropagationLinkGeometry geometry (tx, rx[i]);
+      states[i].m_delayTicks = m_delay->GetDelayTicks (geometry);
+      states[i].m_rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, geometry);
+    }
+  NS_LOG_DEBUG ("Evaluated " << rx.size () << " links");
+}
+
+} // namespace ns3
@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PROPAGATION_LINK_STATE_H
+#define PROPAGATION_LINK_STATE_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include <vector>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup propagation
+ *
+ * \brief The propagation delay and the reception power of a link
+ */
+struct PropagationLinkState
+{
+  /// The propagation delay, in time steps: TimeStep (m_delayTicks) is the delay
+  int64_t m_delayTicks;
+  /// The reception power (dBm)
+  double m_rxPowerDbm;
+};
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Evaluate the delay and the loss of links in one pass
+ *
+ * A channel delivering a packet calls a delay model and a loss model for
+ * each receiver, and both compute the distance between the nodes. The
+ * evaluator builds the PropagationLinkGeometry of the link once and hands
+ * it to PropagationDelayModel::GetDelayTicks and to the loss model chain,
+ * which computes the distance at most once for all of them. The results
+ * are those of GetDelay and CalcRxPower, drawn in the same order: delay
+ * first, then loss.
+ *
+ * The batch Evaluate covers the receivers of a broadcast in a single pass
+ * and fills a vector owned by the caller, which can be reused from one
+ * transmission to the next without allocating.
+ */
+class PropagationLinkStateEvaluator : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  PropagationLinkStateEvaluator ();
+  virtual ~PropagationLinkStateEvaluator ();
+
+  void SetLossModel (Ptr<PropagationLossModel> loss);
+  Ptr<PropagationLossModel> GetLossModel (void) const;
+  void SetDelayModel (Ptr<PropagationDelayModel> delay);
+  Ptr<PropagationDelayModel> GetDelayModel (void) const;
+
+  /**
+   * \param txPowerDbm the transmission power (dBm)
+   * \param a the mobility model of the source
+   * \param b the mobility model of the destination
+   * \returns the delay and reception power of the link a->b
+   */
+  PropagationLinkState Evaluate (double txPowerDbm,
+                                 Ptr<MobilityModel> a,
+                                 Ptr<MobilityModel> b) const;
+  /**
+   * \param txPowerDbm the transmission power (dBm)
+   * \param tx the mobility model of the source
+   * \param rx the mobility models of the destinations
+   * \param states receives the state of the link to rx[i] at index i; it is
+   * resized to the number of receivers
+   */
+  void Evaluate (double txPowerDbm,
+                 Ptr<MobilityModel> tx,
+                 const std::vector<Ptr<MobilityModel> > &rx,
+                 std::vector<PropagationLinkState> &states) const;
+
+private:
+  virtual void DoDispose (void);
+
+  Ptr<PropagationLossModel> m_loss;
+  Ptr<PropagationDelayModel> m_delay;
+};
+
+} // namespace ns3
+
+#endif /* PROPAGATION_LINK_STATE_H */
@@ -28,7 +28,14 @@
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/abort.h"
+#include "ns3/uinteger.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/simulator.h"
 #include <cmath>
+#include <time.h>
+#include <algorithm>
+#include <limits>
 
 NS_LOG_COMPONENT_DEFINE ("PropagationLossModel");
 
@@ -43,13 +50,78 @@ PropagationLossModel::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::PropagationLossModel")
     .SetParent<Object> ()
+    .AddAttribute ("EnableTiming",
+                   "Time every stage of the chain starting at this model.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PropagationLossModel::m_timing),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("StageTime",
+                     "A stage of the chain has been evaluated: its index, model and duration [ns].",
+                     MakeTraceSourceAccessor (&PropagationLossModel::m_stageTimeTrace))
+    .AddTraceSource ("CalcTime",
+                     "The chain has been evaluated, with this duration [ns].",
+                     MakeTraceSourceAccessor (&PropagationLossModel::m_calcTimeTrace))
   ;
   return tid;
 }
 
+const uint32_t PropagationLossModel::TIME_HISTOGRAM_SIZE;
+
 PropagationLossModel::PropagationLossModel ()
-  : m_next (0)
+  : m_next (0),
+    m_geometry (0),
+    m_evaluationTime (0),
+    m_timing (false)
+{
+  ResetTiming ();
+}
+
+/// \returns the monotonic wall clock time [ns]
+static int64_t
+GetWallClockNs (void)
+{
+  struct timespec now;
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t> (now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+uint64_t
+PropagationLossModel::GetTimedCalls (void) const
+{
+  return m_timedCalls;
+}
+
+int64_t
+PropagationLossModel::GetTimedNs (void) const
+{
+  return m_timedNs;
+}
+
+std::vector<uint64_t>
+PropagationLossModel::GetTimeHistogram (void) const
 {
+  return std::vector<uint64_t> (m_timeHistogram, m_timeHistogram + TIME_HISTOGRAM_SIZE);
+}
+
+void
+PropagationLossModel::ResetTiming (void)
+{
+  m_timedCalls = 0;
+  m_timedNs = 0;
+  std::fill (m_timeHistogram, m_timeHistogram + TIME_HISTOGRAM_SIZE, 0);
+}
+
+void
+PropagationLossModel::RecordTime (int64_t ns) const
+{
+  m_timedCalls++;
+  m_timedNs += ns;
+  uint32_t bucket = 0;
+  while (bucket + 1 < TIME_HISTOGRAM_SIZE && (ns >> (bucket + 1)) > 0)
+    {
+      bucket++;
+    }
+  m_timeHistogram[bucket]++;
 }
 
 PropagationLossModel::~PropagationLossModel ()
@@ -73,12 +145,220 @@ PropagationLossModel::CalcRxPower (double txPowerDbm,
                                    Ptr<MobilityModel> a,
                                    Ptr<MobilityModel> b) const
 {
-  double self = DoCalcRxPower (txPowerDbm, a, b);
-  if (m_next != 0)
+  return CalcChain (txPowerDbm, DOMAIN_DBM, -std::numeric_limits<double>::infinity (),
+                    PropagationLinkGeometry (a, b));
+}
+
+double
+PropagationLossModel::CalcRxPowerW (double txPowerW,
+                                    Ptr<MobilityModel> a,
+                                    Ptr<MobilityModel> b) const
+{
+  return CalcChain (txPowerW, DOMAIN_W, 0, PropagationLinkGeometry (a, b));
+}
+
+double
+PropagationLossModel::CalcRxPower (double txPowerDbm,
+                                   Ptr<MobilityModel> a,
+                                   Ptr<MobilityModel> b,
+                                   double cutoffDbm) const
+{
+  return CalcChain (txPowerDbm, DOMAIN_DBM, cutoffDbm, PropagationLinkGeometry (a, b));
+}
+
+double
+PropagationLossModel::CalcRxPowerW (double txPowerW,
+                                    Ptr<MobilityModel> a,
+                                    Ptr<MobilityModel> b,
+                                    double cutoffW) const
+{
+  return CalcChain (txPowerW, DOMAIN_W, cutoffW, PropagationLinkGeometry (a, b));
+}
+
+double
+PropagationLossModel::CalcRxPower (double txPowerDbm,
+                                   const PropagationLinkGeometry &geometry) const
+{
+  return CalcChain (txPowerDbm, DOMAIN_DBM, -std::numeric_limits<double>::infinity (), geometry);
+}
+
+double
+PropagationLossModel::CalcRxPowerW (double txPowerW,
+                                    const PropagationLinkGeometry &geometry) const
+{
+  return CalcChain (txPowerW, DOMAIN_W, 0, geometry);
+}
+
+void
+PropagationLossModel::Sample (double txPowerDbm,
+                              Ptr<MobilityModel> a,
+                              Ptr<MobilityModel> b,
+                              Time start,
+                              Time interval,
+                              uint32_t n,
+                              std::vector<double> &rxPowerDbm) const
+{
+  // the nodes do not move between the samples: one geometry serves them all
+  PropagationLinkGeometry geometry (a, b);
+  rxPowerDbm.resize (n);
+  Time at = start;
+  for (uint32_t i = 0; i < n; i++, at = at + interval)
     {
-      self = m_next->CalcRxPower (self, a, b);
+      rxPowerDbm[i] = CalcChain (txPowerDbm, DOMAIN_DBM, -std::numeric_limits<double>::infinity (),
+                                 geometry, &at);
     }
-  return self;
+}
+
+double
+PropagationLossModel::GetDistance (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  if (m_geometry != 0 && m_geometry->IsLink (a, b))
+    {
+      return m_geometry->GetDistance ();
+    }
+  return a->GetDistanceFrom (b);
+}
+
+Time
+PropagationLossModel::GetEvaluationTime (void) const
+{
+  return m_evaluationTime != 0 ? *m_evaluationTime : Simulator::Now ();
+}
+
+double
+PropagationLossModel::GetMaxGainDb (void) const
+{
+  return std::numeric_limits<double>::infinity ();
+}
+
+uint64_t
+PropagationLossModel::GetNLinks (void) const
+{
+  return 0;
+}
+
+double
+PropagationLossModel::CalcChain (double txPower, PowerDomain domain, double cutoff,
+                                 const PropagationLinkGeometry &geometry, const Time *at) const
+{
+  if (m_timing)
+    {
+      int64_t start = GetWallClockNs ();
+      double power = DoCalcChain<true> (txPower, domain, cutoff, geometry, at);
+      m_calcTimeTrace (GetWallClockNs () - start);
+      return power;
+    }
+  return DoCalcChain<false> (txPower, domain, cutoff, geometry, at);
+}
+
+template <bool timed>
+double
+PropagationLossModel::DoCalcChain (double txPower, PowerDomain domain, double cutoff,
+                                   const PropagationLinkGeometry &geometry, const Time *at) const
+{
+  const double infinity = std::numeric_limits<double>::infinity ();
+  bool hasCutoff = (domain == DOMAIN_W) ? cutoff > 0 : cutoff > -infinity;
+  // the models from index firstBounded on have a bounded gain, of sum boundDb
+  uint32_t firstBounded = 0;
+  double boundDb = 0;
+  double cutoffDbm = 0;
+  double cutoffW = 0;
+  if (hasCutoff)
+    {
+      uint32_t i = 0;
+      for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next), i++)
+        {
+          double maxGainDb = model->GetMaxGainDb ();
+          if (maxGainDb == infinity)
+            {
+              firstBounded = i + 1;
+              boundDb = 0;
+            }
+          else
+            {
+              boundDb += maxGainDb;
+            }
+        }
+      cutoffDbm = (domain == DOMAIN_W) ? WToDbm (cutoff) : cutoff;
+      cutoffW = (domain == DOMAIN_W) ? cutoff : DbmToW (cutoff);
+    }
+
+  Ptr<MobilityModel> a = geometry.GetA ();
+  Ptr<MobilityModel> b = geometry.GetB ();
+  double power = txPower;
+  PowerDomain current = domain;
+  uint32_t i = 0;
+  for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next), i++)
+    {
+      if (hasCutoff && i >= firstBounded)
+        {
+          bool unreachable = (current == DOMAIN_W)
+            ? power * std::pow (10, boundDb / 10) < cutoffW
+            : power + boundDb < cutoffDbm;
+          if (unreachable)
+            {
+              NS_LOG_DEBUG ("power " << power << " below the cutoff, skipping the remaining models");
+              return (domain == DOMAIN_W) ? 0 : -infinity;
+            }
+          boundDb -= model->GetMaxGainDb ();
+        }
+      PowerDomain native = model->GetPowerDomain ();
+      if (native != DOMAIN_ANY && native != current)
+        {
+          power = (native == DOMAIN_W) ? DbmToW (power) : WToDbm (power);
+          current = native;
+        }
+      int64_t start = timed ? GetWallClockNs () : 0;
+      model->m_geometry = &geometry;
+      model->m_evaluationTime = at;
+      if (current == DOMAIN_W)
+        {
+          power = model->DoCalcRxPowerW (power, a, b);
+        }
+      else
+        {
+          power = model->DoCalcRxPower (power, a, b);
+        }
+      model->m_geometry = 0;
+      model->m_evaluationTime = 0;
+      if (timed)
+        {
+          int64_t ns = GetWallClockNs () - start;
+          model->RecordTime (ns);
+          m_stageTimeTrace (i, Ptr<const PropagationLossModel> (model), ns);
+        }
+    }
+  if (current != domain)
+    {
+      power = (domain == DOMAIN_W) ? DbmToW (power) : WToDbm (power);
+    }
+  return power;
+}
+
+PropagationLossModel::PowerDomain
+PropagationLossModel::GetPowerDomain (void) const
+{
+  return DOMAIN_DBM;
+}
+
+double
+PropagationLossModel::DoCalcRxPowerW (double txPowerW,
+                                      Ptr<MobilityModel> a,
+                                      Ptr<MobilityModel> b) const
+{
+  return DbmToW (DoCalcRxPower (WToDbm (txPowerW), a, b));
+}
+
+double
+PropagationLossModel::DbmToW (double powerDbm)
+{
+  return std::pow (10, (powerDbm - 30) / 10);
+}
+
+double
+PropagationLossModel::WToDbm (double powerW)
+{
+  return 10 * std::log10 (powerW) + 30;
 }
 
 int64_t
@@ -93,6 +373,59 @@ PropagationLossModel::AssignStreams (int64_t stream)
   return (currentStream - stream);
 }
 
+/// Magic number and version of a snapshot
+static const uint32_t PROPAGATION_SNAPSHOT_MAGIC = 0x50524f50;
+static const uint32_t PROPAGATION_SNAPSHOT_VERSION = 1;
+
+void
+PropagationLossModel::Serialize (std::ostream &os) const
+{
+  uint32_t n = 0;
+  for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next))
+    {
+      n++;
+    }
+  PropagationSnapshot::WriteU32 (os, PROPAGATION_SNAPSHOT_MAGIC);
+  PropagationSnapshot::WriteU32 (os, PROPAGATION_SNAPSHOT_VERSION);
+  PropagationSnapshot::WriteU32 (os, n);
+  for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next))
+    {
+      PropagationSnapshot::WriteString (os, model->GetInstanceTypeId ().GetName ());
+      model->DoSerialize (os);
+    }
+}
+
+void
+PropagationLossModel::Deserialize (std::istream &is)
+{
+  NS_ABORT_MSG_IF (PropagationSnapshot::ReadU32 (is) != PROPAGATION_SNAPSHOT_MAGIC,
+                   "Not a propagation snapshot");
+  NS_ABORT_MSG_IF (PropagationSnapshot::ReadU32 (is) != PROPAGATION_SNAPSHOT_VERSION,
+                   "Unsupported propagation snapshot version");
+  uint32_t n = PropagationSnapshot::ReadU32 (is);
+  PropagationLossModel *model = this;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      NS_ABORT_MSG_IF (model == 0, "The snapshot has more models than the chain");
+      std::string name = PropagationSnapshot::ReadString (is);
+      NS_ABORT_MSG_IF (name != model->GetInstanceTypeId ().GetName (),
+                       "Snapshot of " << name << " cannot be restored into " << model->GetInstanceTypeId ().GetName ());
+      model->DoDeserialize (is);
+      model = PeekPointer (model->m_next);
+    }
+  NS_ABORT_MSG_IF (model != 0, "The chain has more models than the snapshot");
+}
+
+void
+PropagationLossModel::DoSerialize (std::ostream &os) const
+{
+}
+
+void
+PropagationLossModel::DoDeserialize (std::istream &is)
+{
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (RandomPropagationLossModel);
@@ -125,6 +458,7 @@ RandomPropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                            Ptr<MobilityModel> b) const
 {
   double rxc = -m_variable->GetValue ();
+  m_draws.Record ();
   NS_LOG_DEBUG ("attenuation coefficent="<<rxc<<"Db");
   return txPowerDbm + rxc;
 }
@@ -136,6 +470,22 @@ RandomPropagationLossModel::DoAssignStreams (int64_t stream)
   return 1;
 }
 
+void
+RandomPropagationLossModel::DoSerialize (std::ostream &os) const
+{
+  m_draws.Write (os);
+}
+
+void
+RandomPropagationLossModel::DoDeserialize (std::istream &is)
+{
+  m_draws.Read (is);
+  for (uint64_t i = 0; i < m_draws.GetNDraws (); i++)
+    {
+      m_variable->GetValue ();
+    }
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (FriisPropagationLossModel);
@@ -254,7 +604,7 @@ FriisPropagationLossModel::DoCalcRxPower (double txPowerDbm,
    * L: system loss (unit-less)
    * lambda: wavelength (m)
    */
-  double distance = a->GetDistanceFrom (b);
+  double distance = GetDistance (a, b);
   if (distance <= m_minDistance)
     {
       return txPowerDbm;
@@ -398,7 +748,7 @@ TwoRayGroundPropagationLossModel::DoCalcRxPower (double txPowerDbm,
    * rx = tx + 10 log10 (-----------------------)
    *                      (d * d * d * d) * L
    */
-  double distance = a->GetDistanceFrom (b);
+  double distance = GetDistance (a, b);
   if (distance <= m_minDistance)
     {
       return txPowerDbm;
@@ -503,7 +853,7 @@ LogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                                 Ptr<MobilityModel> a,
                                                 Ptr<MobilityModel> b) const
 {
-  double distance = a->GetDistanceFrom (b);
+  double distance = GetDistance (a, b);
   if (distance <= m_referenceDistance)
     {
       return txPowerDbm;
@@ -594,7 +944,7 @@ ThreeLogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                                      Ptr<MobilityModel> a,
                                                      Ptr<MobilityModel> b) const
 {
-  double distance = a->GetDistanceFrom (b);
+  double distance = GetDistance (a, b);
   NS_ASSERT (distance >= 0);
 
   // See doxygen comments for the formula and explanation
@@ -680,43 +1030,287 @@ NakagamiPropagationLossModel::GetTypeId (void)
                    "Access to the underlying GammaRandomVariable",
                    StringValue ("ns3::GammaRandomVariable"),
                    MakePointerAccessor (&NakagamiPropagationLossModel::m_gammaRandomVariable),
-                   MakePointerChecker<GammaRandomVariable> ());
+                   MakePointerChecker<GammaRandomVariable> ())
+    .AddAttribute ("UniformRv",
+                   "Access to the underlying UniformRandomVariable used with UseInverseCdfTable",
+                   StringValue ("ns3::UniformRandomVariable"),
+                   MakePointerAccessor (&NakagamiPropagationLossModel::m_uniformRandomVariable),
+                   MakePointerChecker<UniformRandomVariable> ())
+    .AddAttribute ("UseInverseCdfTable",
+                   "Sample the gain from a tabulated inverse CDF instead of a Gamma or Erlang variable. "
+                   "The model then assigns a third stream, so set this before AssignStreams.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NakagamiPropagationLossModel::m_useTable),
+                   MakeBooleanChecker ())
+    .AddAttribute ("TableSize",
+                   "Number of intervals of the inverse CDF tables.",
+                   UintegerValue (4096),
+                   MakeUintegerAccessor (&NakagamiPropagationLossModel::m_tableSize),
+                   MakeUintegerChecker<uint32_t> (4))
+    .AddAttribute ("CounterBasedStreams",
+                   "Draw the gains from per-link counter-based sequences, independent of the evaluation order.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NakagamiPropagationLossModel::m_counterBased),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxGainQuantile",
+                   "Quantile of the gain reported by GetMaxGainDb, used to skip the model below a cutoff.",
+                   DoubleValue (0.9999),
+                   MakeDoubleAccessor (&NakagamiPropagationLossModel::m_maxGainQuantile),
+                   MakeDoubleChecker<double> (0.0, 1.0))
   ;
   return tid;
 
 }
 
 NakagamiPropagationLossModel::NakagamiPropagationLossModel ()
+  : m_erlangDraws (false),
+    m_uniformDraws (0),
+    m_useTable (false),
+    m_tableSize (4096),
+    m_counterBased (false),
+    m_maxGainQuantile (0.9999),
+    m_maxGainDb (0)
+{
+  for (unsigned int i = 0; i < 4; i++)
+    {
+      m_maxGainParameters[i] = -1;
+    }
+}
+
+uint64_t
+NakagamiPropagationLossModel::GetNLinks (void) const
 {
+  return m_rng.GetNLinks ();
 }
 
 double
-NakagamiPropagationLossModel::DoCalcRxPower (double txPowerDbm,
-                                             Ptr<MobilityModel> a,
-                                             Ptr<MobilityModel> b) const
+NakagamiPropagationLossModel::GetMaxGainDb (void) const
+{
+  double parameters[4] = { m_m0, m_m1, m_m2, m_maxGainQuantile };
+  if (!std::equal (parameters, parameters + 4, m_maxGainParameters))
+    {
+      std::copy (parameters, parameters + 4, m_maxGainParameters);
+      if (m_maxGainQuantile >= 1)
+        {
+          m_maxGainDb = std::numeric_limits<double>::infinity ();
+        }
+      else
+        {
+          m_maxGainDb = std::max (GetQuantileDb (m_m0, m_maxGainQuantile),
+                                  std::max (GetQuantileDb (m_m1, m_maxGainQuantile),
+                                            GetQuantileDb (m_m2, m_maxGainQuantile)));
+        }
+    }
+  return m_maxGainDb;
+}
+
+/**
+ * Regularized lower incomplete gamma function P(a, x), by its series for
+ * x < a + 1 and by the continued fraction of Q(a, x) = 1 - P(a, x) otherwise
+ */
+static double
+RegularizedGammaP (double a, double x)
+{
+  if (x <= 0)
+    {
+      return 0;
+    }
+  double prefactor = std::exp (-x + a * std::log (x) - lgamma (a));
+  if (x < a + 1)
+    {
+      double term = 1 / a;
+      double sum = term;
+      for (int n = 1; n < 1000; n++)
+        {
+          term *= x / (a + n);
+          sum += term;
+          if (std::fabs (term) < std::fabs (sum) * 1e-16)
+            {
+              break;
+            }
+        }
+      return sum * prefactor;
+    }
+  // modified Lentz's method
+  const double tiny = 1e-300;
+  double b = x + 1 - a;
+  double c = 1 / tiny;
+  double d = 1 / b;
+  double h = d;
+  for (int n = 1; n < 1000; n++)
+    {
+      double an = -n * (n - a);
+      b += 2;
+      d = an * d + b;
+      d = std::fabs (d) < tiny ? tiny : d;
+      c = b + an / c;
+      c = std::fabs (c) < tiny ? tiny : c;
+      d = 1 / d;
+      double delta = d * c;
+      h *= delta;
+      if (std::fabs (delta - 1) < 1e-16)
+        {
+          break;
+        }
+    }
+  return 1 - prefactor * h;
+}
+
+double
+NakagamiPropagationLossModel::GetQuantileDb (double m, double u)
+{
+  // solve P(m, y) = u for y by Newton's method, safeguarded by bisection
+  double lo = 0;
+  double hi = std::max (1.0, m);
+  while (RegularizedGammaP (m, hi) < u)
+    {
+      lo = hi;
+      hi *= 2;
+    }
+  // small quantiles: P(m, y) ~ y^m / Gamma(m + 1)
+  double y = std::pow (u * std::exp (lgamma (m + 1)), 1 / m);
+  if (y == 0)
+    {
+      return -std::numeric_limits<double>::infinity ();
+    }
+  if (y <= lo || y >= hi)
+    {
+      y = (lo + hi) / 2;
+    }
+  for (int i = 0; i < 200; i++)
+    {
+      double f = RegularizedGammaP (m, y) - u;
+      if (f < 0)
+        {
+          lo = y;
+        }
+      else
+        {
+          hi = y;
+        }
+      double density = std::exp ((m - 1) * std::log (y) - y - lgamma (m));
+      double next = y - f / density;
+      if (!(next > lo && next < hi))
+        {
+          next = (lo + hi) / 2;
+        }
+      if (std::fabs (next - y) <= 1e-15 * y)
+        {
+          y = next;
+          break;
+        }
+      y = next;
+    }
+  // the unit mean Gamma variable of shape m is y / m
+  return 10 * std::log10 (y / m);
+}
+
+const NakagamiPropagationLossModel::InverseCdfTable &
+NakagamiPropagationLossModel::GetTable (unsigned int i, double m) const
 {
-  // select m parameter
+  InverseCdfTable &table = m_tables[i];
+  if (table.m_gainDb.size () != m_tableSize + 1 || table.m_m != m)
+    {
+      NS_LOG_DEBUG ("Building the inverse CDF table of m=" << m);
+      table.m_m = m;
+      table.m_gainDb.assign (m_tableSize + 1, 0);
+      // entries 0 and K are unbounded and never read
+      for (uint32_t k = 1; k < m_tableSize; k++)
+        {
+          table.m_gainDb[k] = GetQuantileDb (m, static_cast<double> (k) / m_tableSize);
+        }
+    }
+  return table;
+}
 
-  double distance = a->GetDistanceFrom (b);
+double
+NakagamiPropagationLossModel::GetShape (Ptr<MobilityModel> a,
+                                        Ptr<MobilityModel> b,
+                                        unsigned int &field) const
+{
+  double distance = GetDistance (a, b);
   NS_ASSERT (distance >= 0);
+  NS_LOG_DEBUG ("Nakagami distance=" << distance << "m");
 
-  double m;
   if (distance < m_distance1)
     {
-      m = m_m0;
+      field = 0;
+      return m_m0;
     }
   else if (distance < m_distance2)
     {
-      m = m_m1;
+      field = 1;
+      return m_m1;
+    }
+  field = 2;
+  return m_m2;
+}
+
+double
+NakagamiPropagationLossModel::GetTableGainDb (Ptr<MobilityModel> a, Ptr<MobilityModel> b,
+                                              unsigned int field, double m) const
+{
+  const InverseCdfTable &table = GetTable (field, m);
+  double u;
+  if (m_counterBased)
+    {
+      m_rng.SeekLink (a, b);
+      u = m_rng.GetUniform ();
     }
   else
     {
-      m = m_m2;
+      u = m_uniformRandomVariable->GetValue ();
+      m_uniformDraws++;
     }
+  double position = u * m_tableSize;
+  uint32_t k = static_cast<uint32_t> (position);
+  double gainDb;
+  if (k == 0 || k >= m_tableSize - 1)
+    {
+      gainDb = GetQuantileDb (m, std::max (u, std::numeric_limits<double>::min ()));
+    }
+  else
+    {
+      double fraction = position - k;
+      gainDb = table.m_gainDb[k] + fraction * (table.m_gainDb[k + 1] - table.m_gainDb[k]);
+    }
+  NS_LOG_DEBUG ("table gain=" << gainDb << "dB");
+  return gainDb;
+}
 
+NakagamiPropagationLossModel::PowerDomain
+NakagamiPropagationLossModel::GetPowerDomain (void) const
+{
+  return m_useTable ? DOMAIN_DBM : DOMAIN_W;
+}
+
+double
+NakagamiPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                             Ptr<MobilityModel> a,
+                                             Ptr<MobilityModel> b) const
+{
+  if (m_useTable)
+    {
+      unsigned int field;
+      double m = GetShape (a, b, field);
+      return txPowerDbm + GetTableGainDb (a, b, field, m);
+    }
   // the current power unit is dBm, but Watt is put into the Nakagami /
   // Rayleigh distribution.
-  double powerW = std::pow (10, (txPowerDbm - 30) / 10);
+  return WToDbm (DoCalcRxPowerW (DbmToW (txPowerDbm), a, b));
+}
+
+double
+NakagamiPropagationLossModel::DoCalcRxPowerW (double powerW,
+                                              Ptr<MobilityModel> a,
+                                              Ptr<MobilityModel> b) const
+{
+  unsigned int field;
+  double m = GetShape (a, b, field);
+  if (m_useTable)
+    {
+      return powerW * std::pow (10, GetTableGainDb (a, b, field, m) / 10);
+    }
 
   double resultPowerW;
 
@@ -724,22 +1318,25 @@ NakagamiPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   // speed. (Gamma is equal to Erlang for any positive integer m.)
   unsigned int int_m = static_cast<unsigned int>(std::floor (m));
 
-  if (int_m == m)
+  if (m_counterBased)
+    {
+      m_rng.SeekLink (a, b);
+      resultPowerW = m_rng.GetGamma (m, powerW / m);
+    }
+  else if (int_m == m)
     {
       resultPowerW = m_erlangRandomVariable->GetValue (int_m, powerW / m);
+      m_erlangDraws.Record (int_m);
     }
   else
     {
       resultPowerW = m_gammaRandomVariable->GetValue (m, powerW / m);
+      m_gammaDraws.Record (m);
     }
 
-  double resultPowerDbm = 10 * std::log10 (resultPowerW) + 30;
-
-  NS_LOG_DEBUG ("Nakagami distance=" << distance << "m, " <<
-                "power=" << powerW <<"W, " <<
-                "resultPower=" << resultPowerW << "W=" << resultPowerDbm << "dBm");
+  NS_LOG_DEBUG ("power=" << powerW << "W, resultPower=" << resultPowerW << "W");
 
-  return resultPowerDbm;
+  return resultPowerW;
 }
 
 int64_t
@@ -747,7 +1344,56 @@ NakagamiPropagationLossModel::DoAssignStreams (int64_t stream)
 {
   m_erlangRandomVariable->SetStream (stream);
   m_gammaRandomVariable->SetStream (stream + 1);
-  return 2;
+  m_rng.SetStream (stream);
+  if (!m_useTable)
+    {
+      // the uniform variable only serves the table: the models chained
+      // after this one keep their streams
+      return 2;
+    }
+  m_uniformRandomVariable->SetStream (stream + 2);
+  return 3;
+}
+
+void
+NakagamiPropagationLossModel::DoSerialize (std::ostream &os) const
+{
+  m_erlangDraws.Write (os);
+  m_gammaDraws.Write (os);
+  PropagationSnapshot::WriteU64 (os, m_uniformDraws);
+  m_rng.Write (os);
+}
+
+void
+NakagamiPropagationLossModel::DoDeserialize (std::istream &is)
+{
+  NS_ABORT_MSG_IF (m_erlangDraws.GetNDraws () != 0 || m_gammaDraws.GetNDraws () != 0 || m_uniformDraws != 0,
+                   "A snapshot can only be restored into an unused NakagamiPropagationLossModel");
+  // the scale does not change the number of uniforms a draw consumes
+  m_erlangDraws.Read (is);
+  for (uint32_t i = 0; i < m_erlangDraws.GetNRuns (); i++)
+    {
+      unsigned int k = static_cast<unsigned int> (m_erlangDraws.GetParameter (i));
+      for (uint64_t j = 0; j < m_erlangDraws.GetCount (i); j++)
+        {
+          m_erlangRandomVariable->GetValue (k, 1.0);
+        }
+    }
+  m_gammaDraws.Read (is);
+  for (uint32_t i = 0; i < m_gammaDraws.GetNRuns (); i++)
+    {
+      double alpha = m_gammaDraws.GetParameter (i);
+      for (uint64_t j = 0; j < m_gammaDraws.GetCount (i); j++)
+        {
+          m_gammaRandomVariable->GetValue (alpha, 1.0);
+        }
+    }
+  uint64_t uniformDraws = PropagationSnapshot::ReadU64 (is);
+  for (; m_uniformDraws < uniformDraws; m_uniformDraws++)
+    {
+      m_uniformRandomVariable->GetValue ();
+    }
+  m_rng.Read (is);
 }
 
 // ------------------------------------------------------------------------- //
@@ -903,7 +1549,7 @@ RangePropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                           Ptr<MobilityModel> a,
                                           Ptr<MobilityModel> b) const
 {
-  double distance = a->GetDistanceFrom (b);
+  double distance = GetDistance (a, b);
   if (distance <= m_range)
     {
       return txPowerDbm;
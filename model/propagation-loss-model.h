@@ -26,8 +26,15 @@
 #define PROPAGATION_LOSS_MODEL_H
 
 #include "ns3/object.h"
+#include "ns3/nstime.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
+#include "ns3/propagation-snapshot.h"
+#include "ns3/counter-based-rng.h"
+#include "ns3/propagation-link-geometry.h"
 #include <map>
+#include <vector>
+#include <iostream>
 
 namespace ns3 {
 
@@ -45,10 +52,34 @@ class MobilityModel;
  *
  * Calculate the receive power (dbm) from a transmit power (dbm)
  * and a mobility model for the source and destination positions.
+ *
+ * Each model computes in its native power domain, see GetPowerDomain:
+ * dBm (DoCalcRxPower), Watt (DoCalcRxPowerW), or either. A chain carries
+ * the power from one model to the next in the domain of the last model
+ * and converts it only where the domain changes and at the output, so a
+ * chain of Watt models called through CalcRxPowerW does no conversion.
+ *
+ * With the EnableTiming attribute of the first model of a chain, every
+ * stage is timed with the monotonic wall clock: each model counts its
+ * calls, their total time and a histogram of their durations, and the
+ * first model fires the StageTime and CalcTime trace sources. Timing can
+ * be switched on and off during a simulation; when off, the chain only
+ * tests the attribute once per call.
  */
 class PropagationLossModel : public Object
 {
 public:
+  /// Unit of the power passed to and returned by a model
+  enum PowerDomain
+  {
+    /// dBm, through DoCalcRxPower
+    DOMAIN_DBM,
+    /// Watt, through DoCalcRxPowerW
+    DOMAIN_W,
+    /// both are equally cheap: the model works in the domain of its input
+    DOMAIN_ANY
+  };
+
   static TypeId GetTypeId (void);
 
   PropagationLossModel ();
@@ -85,6 +116,123 @@ public:
                       Ptr<MobilityModel> a,
                       Ptr<MobilityModel> b) const;
 
+  /**
+   * \param txPowerW current transmission power (in W)
+   * \param a the mobility model of the source
+   * \param b the mobility model of the destination
+   * \returns the reception power after adding/multiplying propagation loss (in W)
+   *
+   * Same as CalcRxPower, for callers that work with linear power, e.g. to
+   * sum interference.
+   */
+  double CalcRxPowerW (double txPowerW,
+                       Ptr<MobilityModel> a,
+                       Ptr<MobilityModel> b) const;
+
+  /**
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param a the mobility model of the source
+   * \param b the mobility model of the destination
+   * \param cutoffDbm the power (in dBm) below which the result does not matter
+   * \returns the reception power (in dBm), or -infinity if it is known to
+   * be below cutoffDbm
+   *
+   * Before each model, the chain adds the bounds of GetMaxGainDb of the
+   * remaining models to the current power; if even that stays below
+   * cutoffDbm, the remaining models are skipped and draw nothing. Models
+   * with an unbounded gain (e.g. path loss models) are always evaluated,
+   * so the skip happens after the last of them.
+   */
+  double CalcRxPower (double txPowerDbm,
+                      Ptr<MobilityModel> a,
+                      Ptr<MobilityModel> b,
+                      double cutoffDbm) const;
+  /// Same as the CalcRxPower with a cutoff, in Watt; returns 0 below cutoffW
+  double CalcRxPowerW (double txPowerW,
+                       Ptr<MobilityModel> a,
+                       Ptr<MobilityModel> b,
+                       double cutoffW) const;
+
+  /**
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param geometry the geometry of the link, shared by all the models
+   * \returns the reception power (in dBm)
+   *
+   * Same as CalcRxPower, for callers that also use the geometry of the
+   * link elsewhere, e.g. for the propagation delay.
+   */
+  double CalcRxPower (double txPowerDbm,
+                      const PropagationLinkGeometry &geometry) const;
+  /// Same as the CalcRxPower with a geometry, in Watt
+  double CalcRxPowerW (double txPowerW,
+                       const PropagationLinkGeometry &geometry) const;
+
+  /**
+   * \param txPowerDbm the transmission power (dBm)
+   * \param a the mobility model of the source
+   * \param b the mobility model of the destination
+   * \param start the time of the first sample
+   * \param interval the time between two samples, 0 for n samples at start
+   * \param n the number of samples
+   * \param rxPowerDbm receives the reception powers (dBm), resized to n
+   *
+   * Evaluates the chain n times, as CalcRxPower would at the times
+   * start + i interval, without running the simulator: the models see
+   * these times instead of the simulation time. Models drawing a value
+   * per call draw one per sample. The nodes keep their current positions,
+   * and the times may be earlier than the simulation time.
+   */
+  void Sample (double txPowerDbm,
+               Ptr<MobilityModel> a,
+               Ptr<MobilityModel> b,
+               Time start,
+               Time interval,
+               uint32_t n,
+               std::vector<double> &rxPowerDbm) const;
+
+  /**
+   * \returns an upper bound of the gain [dB] this model adds, +infinity
+   * (the default) if there is none
+   *
+   * Stochastic models return a high quantile of their gain, set by their
+   * MaxGainQuantile attribute, rather than a strict maximum.
+   */
+  virtual double GetMaxGainDb (void) const;
+
+  /**
+   * \returns the number of per-link states this model holds (processes,
+   * frozen draws, stream positions...), 0 for a model without any
+   *
+   * This only counts this model, not the chained models.
+   */
+  virtual uint64_t GetNLinks (void) const;
+
+  /// Number of buckets of the histogram of GetTimeHistogram
+  static const uint32_t TIME_HISTOGRAM_SIZE = 32;
+  /// \returns the number of calls of this model timed with EnableTiming
+  uint64_t GetTimedCalls (void) const;
+  /// \returns the total time [ns] of the timed calls of this model
+  int64_t GetTimedNs (void) const;
+  /**
+   * \returns the histogram of the durations of the timed calls: bucket k
+   * counts the calls that took 2^k to 2^(k+1)-1 ns (bucket 0 also counts
+   * those under 1 ns, the last bucket all the longer ones)
+   */
+  std::vector<uint64_t> GetTimeHistogram (void) const;
+  /// Reset the call count, total time and histogram of this model
+  void ResetTiming (void);
+
+  /**
+   * \returns the domain in which this model computes the received power;
+   * the default is DOMAIN_DBM
+   */
+  virtual PowerDomain GetPowerDomain (void) const;
+
+  /// \returns the power in W of powerDbm
+  static double DbmToW (double powerDbm);
+  /// \returns the power in dBm of powerW
+  static double WToDbm (double powerW);
+
   /**
    * If this loss model uses objects of type RandomVariableStream,
    * set the stream numbers to the integers starting with the offset
@@ -98,12 +246,73 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \brief Save the stochastic state of this model and of the chained models
+   * \param os the binary stream receiving the snapshot
+   *
+   * The snapshot holds the per-link state of the models (e.g. the
+   * oscillators of every JakesProcess) and the position of their random
+   * variable streams, see RandomDrawLog.
+   */
+  void Serialize (std::ostream &os) const;
+
+  /**
+   * \brief Restore the state saved by Serialize
+   * \param is the binary stream holding the snapshot
+   *
+   * The chain must hold models of the same types as the saved chain, be
+   * configured with the same attributes, and have drawn no random value
+   * yet. The seed, run and streams (see AssignStreams) must be the same as
+   * in the saved simulation, and the nodes must have been created in the
+   * same order.
+   */
+  void Deserialize (std::istream &is);
+
+protected:
+  /**
+   * \returns the distance between a and b
+   *
+   * During the evaluation of a chain, the distance is computed once and
+   * shared by the models; models use this rather than GetDistanceFrom.
+   */
+  double GetDistance (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+  /**
+   * \returns the time of the evaluation: the time of the sample during
+   * Sample, the simulation time otherwise
+   *
+   * Time-varying models use this rather than Simulator::Now.
+   */
+  Time GetEvaluationTime (void) const;
+
 private:
   PropagationLossModel (const PropagationLossModel &o);
   PropagationLossModel &operator = (const PropagationLossModel &o);
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const = 0;
+  /**
+   * Subclasses working in Watt override this and GetPowerDomain; the
+   * default converts to dBm around DoCalcRxPower
+   */
+  virtual double DoCalcRxPowerW (double txPowerW,
+                                 Ptr<MobilityModel> a,
+                                 Ptr<MobilityModel> b) const;
+  /**
+   * Evaluate the chain from this model on
+   * \param txPower the transmission power, in domain
+   * \param domain DOMAIN_DBM or DOMAIN_W, the unit of txPower and of the result
+   * \param cutoff the cutoff power, in domain; 0 W or -infinity dBm for none
+   * \param geometry the link
+   * \param at the time of the evaluation, 0 for the simulation time
+   */
+  double CalcChain (double txPower, PowerDomain domain, double cutoff,
+                    const PropagationLinkGeometry &geometry, const Time *at = 0) const;
+  /// CalcChain, with the stages timed if timed is true
+  template <bool timed>
+  double DoCalcChain (double txPower, PowerDomain domain, double cutoff,
+                      const PropagationLinkGeometry &geometry, const Time *at) const;
+  /// Account a call of this model that took ns
+  void RecordTime (int64_t ns) const;
 
   /**
    * Subclasses must implement this; those not using random variables
@@ -111,7 +320,27 @@ private:
    */
   virtual int64_t DoAssignStreams (int64_t stream) = 0;
 
+  /**
+   * Subclasses with state that changes during a simulation implement
+   * these; the default saves nothing
+   */
+  virtual void DoSerialize (std::ostream &os) const;
+  virtual void DoDeserialize (std::istream &is);
+
   Ptr<PropagationLossModel> m_next;
+  /// The link being evaluated by CalcChain, 0 outside of it
+  mutable const PropagationLinkGeometry *m_geometry;
+  /// The time given to CalcChain, 0 outside of it or for the simulation time
+  mutable const Time *m_evaluationTime;
+
+  bool m_timing;
+  mutable uint64_t m_timedCalls;
+  mutable int64_t m_timedNs;
+  mutable uint64_t m_timeHistogram[TIME_HISTOGRAM_SIZE];
+  /// Stage index in the chain, model of the stage and its duration [ns]
+  TracedCallback<uint32_t, Ptr<const PropagationLossModel>, int64_t> m_stageTimeTrace;
+  /// Duration [ns] of a whole chain evaluation
+  TracedCallback<int64_t> m_calcTimeTrace;
 };
 
 /**
@@ -134,7 +363,10 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual void DoSerialize (std::ostream &os) const;
+  virtual void DoDeserialize (std::istream &is);
   Ptr<RandomVariableStream> m_variable;
+  mutable RandomDrawLog m_draws;
 };
 
 /**
@@ -468,6 +700,25 @@ private:
  *
  * For m = 1 the Nakagami-m distribution equals the Rayleigh distribution. Thus
  * this model also implements Rayleigh distribution based fast fading.
+ *
+ * With UseInverseCdfTable set, the power gain is instead sampled by
+ * inversion: for each of the three m values, the quantiles
+ * \f$ 10 \log_{10} F_m^{-1}(k/K) \f$ of the unit mean Gamma distribution
+ * are tabulated once for \f$ k = 1 \ldots K-1 \f$, K being TableSize. A call
+ * then draws one uniform \f$u\f$, interpolates the table linearly and adds
+ * the gain to the power in dBm. Each table interval holds exactly the
+ * probability 1/K, so the CDF error is below 1/K; in the first and last
+ * intervals, where the quantile function is unbounded, the quantile is
+ * computed exactly.
+ *
+ * The model works in Watt (see PropagationLossModel::GetPowerDomain),
+ * and in dBm with UseInverseCdfTable.
+ *
+ * With CounterBasedStreams, the gains are drawn from the per-link
+ * sequences of a CounterBasedRng on the first assigned stream instead,
+ * so that they do not depend on the order in which links are evaluated.
+ * The nodes of both mobility models must
+ * exist.
  */
 class NakagamiPropagationLossModel : public PropagationLossModel
 {
@@ -478,6 +729,14 @@ public:
 
   // Parameters are all accessible via attributes.
 
+  /// \returns the gain [dB] of quantile u of the unit mean Gamma distribution of shape m
+  static double GetQuantileDb (double m, double u);
+
+  /// \returns the largest MaxGainQuantile quantile of the gain over the three m
+  virtual double GetMaxGainDb (void) const;
+  /// \returns the number of link sequences of CounterBasedStreams
+  virtual uint64_t GetNLinks (void) const;
+
 private:
   NakagamiPropagationLossModel (const NakagamiPropagationLossModel& o);
   NakagamiPropagationLossModel& operator= (const NakagamiPropagationLossModel& o);
@@ -485,7 +744,13 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual double DoCalcRxPowerW (double txPowerW,
+                                 Ptr<MobilityModel> a,
+                                 Ptr<MobilityModel> b) const;
+  virtual PowerDomain GetPowerDomain (void) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual void DoSerialize (std::ostream &os) const;
+  virtual void DoDeserialize (std::istream &is);
 
   double m_distance1;
   double m_distance2;
@@ -494,8 +759,41 @@ private:
   double m_m1;
   double m_m2;
 
+  /// Tabulated quantiles [dB] of the unit mean Gamma distribution of shape m_m
+  struct InverseCdfTable
+  {
+    double m_m;
+    std::vector<double> m_gainDb;
+  };
+  /// \returns the table of m for distance field i, built on first use
+  const InverseCdfTable & GetTable (unsigned int i, double m) const;
+  /// \returns the shape m for the distance between a and b, and in field its distance field
+  double GetShape (Ptr<MobilityModel> a, Ptr<MobilityModel> b, unsigned int &field) const;
+  /// \returns a gain [dB] for the link a<->b, sampled from the table of field
+  double GetTableGainDb (Ptr<MobilityModel> a, Ptr<MobilityModel> b,
+                         unsigned int field, double m) const;
+
   Ptr<ErlangRandomVariable>  m_erlangRandomVariable;
   Ptr<GammaRandomVariable> m_gammaRandomVariable;
+  Ptr<UniformRandomVariable> m_uniformRandomVariable;
+  /// Shape of every draw, which sets the number of uniforms it consumes;
+  /// an Erlang draw of shape k consumes k uniforms whatever the order
+  mutable RandomDrawLog m_erlangDraws;
+  mutable RandomDrawLog m_gammaDraws;
+  mutable uint64_t m_uniformDraws;
+
+  bool m_useTable;
+  uint32_t m_tableSize;
+  /// One table per distance field
+  mutable InverseCdfTable m_tables[3];
+
+  bool m_counterBased;
+  mutable CounterBasedRng m_rng;
+
+  double m_maxGainQuantile;
+  /// GetMaxGainDb, and the m0, m1, m2 and quantile it was computed for
+  mutable double m_maxGainDb;
+  mutable double m_maxGainParameters[4];
 };
 
 /**
@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "propagation-snapshot.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/abort.h"
+#include <algorithm>
+
+namespace ns3 {
+
+void
+PropagationSnapshot::WriteU32 (std::ostream &os, uint32_t value)
+{
+  os.write (reinterpret_cast<const char *> (&value), sizeof (value));
+}
+
+uint32_t
+PropagationSnapshot::ReadU32 (std::istream &is)
+{
+  uint32_t value = 0;
+  is.read (reinterpret_cast<char *> (&value), sizeof (value));
+  NS_ABORT_MSG_IF (!is, "Truncated propagation snapshot");
+  return value;
+}
+
+void
+PropagationSnapshot::WriteU64 (std::ostream &os, uint64_t value)
+{
+  os.write (reinterpret_cast<const char *> (&value), sizeof (value));
+}
+
+uint64_t
+PropagationSnapshot::ReadU64 (std::istream &is)
+{
+  uint64_t value = 0;
+  is.read (reinterpret_cast<char *> (&value), sizeof (value));
+  NS_ABORT_MSG_IF (!is, "Truncated propagation snapshot");
+  return value;
+}
+
+void
+PropagationSnapshot::WriteDouble (std::ostream &os, double value)
+{
+  os.write (reinterpret_cast<const char *> (&value), sizeof (value));
+}
+
+double
+PropagationSnapshot::ReadDouble (std::istream &is)
+{
+  double value = 0;
+  is.read (reinterpret_cast<char *> (&value), sizeof (value));
+  NS_ABORT_MSG_IF (!is, "Truncated propagation snapshot");
+  return value;
+}
+
+void
+PropagationSnapshot::WriteString (std::ostream &os, const std::string &value)
+{
+  WriteU32 (os, value.size ());
+  os.write (value.data (), value.size ());
+}
+
+std::string
+PropagationSnapshot::ReadString (std::istream &is)
+{
+  uint32_t size = ReadU32 (is);
+  std::string value (size, ' ');
+  if (size > 0)
+    {
+      is.read (&value[0], size);
+    }
+  NS_ABORT_MSG_IF (!is, "Truncated propagation snapshot");
+  return value;
+}
+
+void
+PropagationSnapshot::WriteMobility (std::ostream &os, Ptr<const MobilityModel> mobility)
+{
+  Ptr<Node> node = mobility->GetObject<Node> ();
+  NS_ABORT_MSG_IF (node == 0, "Only mobility models aggregated to a node can be saved");
+  WriteU32 (os, node->GetId ());
+}
+
+Ptr<MobilityModel>
+PropagationSnapshot::ReadMobility (std::istream &is)
+{
+  uint32_t id = ReadU32 (is);
+  NS_ABORT_MSG_IF (id >= NodeList::GetNNodes (), "Snapshot refers to node " << id << " which does not exist");
+  Ptr<MobilityModel> mobility = NodeList::GetNode (id)->GetObject<MobilityModel> ();
+  NS_ABORT_MSG_IF (mobility == 0, "Node " << id << " of the snapshot has no mobility model");
+  return mobility;
+}
+
+RandomDrawLog::RandomDrawLog (bool ordered)
+  : m_ordered (ordered)
+{
+}
+
+void
+RandomDrawLog::StartRun (double parameter)
+{
+  if (!m_ordered)
+    {
+      for (uint32_t i = 0; i < m_runs.size (); i++)
+        {
+          if (m_runs[i].first == parameter)
+            {
+              std::swap (m_runs[i], m_runs.back ());
+              return;
+            }
+        }
+    }
+  m_runs.push_back (std::make_pair (parameter, static_cast<uint64_t> (0)));
+}
+
+uint32_t
+RandomDrawLog::GetNRuns (void) const
+{
+  return m_runs.size ();
+}
+
+double
+RandomDrawLog::GetParameter (uint32_t i) const
+{
+  return m_runs[i].first;
+}
+
+uint64_t
+RandomDrawLog::GetCount (uint32_t i) const
+{
+  return m_runs[i].second;
+}
+
+uint64_t
+RandomDrawLog::GetNDraws (void) const
+{
+  uint64_t draws = 0;
+  for (uint32_t i = 0; i < m_runs.size (); i++)
+    {
+      draws += m_runs[i].second;
+    }
+  return draws;
+}
+
+void
+RandomDrawLog::Clear (void)
+{
+  m_runs.clear ();
+}
+
+void
+RandomDrawLog::Write (std::ostream &os) const
+{
+  PropagationSnapshot::WriteU32 (os, m_runs.size ());
+  for (uint32_t i = 0; i < m_runs.size (); i++)
+    {
+      PropagationSnapshot::WriteDouble (os, m_runs[i].first);
+      PropagationSnapshot::WriteU64 (os, m_runs[i].second);
+    }
+}
+
+void
+RandomDrawLog::Read (std::istream &is)
+{
+  Clear ();
+  uint32_t n = PropagationSnapshot::ReadU32 (is);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double parameter = PropagationSnapshot::ReadDouble (is);
+      uint64_t count = PropagationSnapshot::ReadU64 (is);
+      m_runs.push_back (std::make_pair (parameter, count));
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PROPAGATION_SNAPSHOT_H
+#define PROPAGATION_SNAPSHOT_H
+
+#include "ns3/ptr.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdint.h>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Binary encoding of the state saved by PropagationLossModel::Serialize
+ *
+ * Values are written in host byte order: a snapshot is meant to be
+ * restored by the same build on the same machine type. A mobility model
+ * is written as the id of the node it is aggregated to, which requires
+ * the restored simulation to create its nodes in the same order.
+ */
+class PropagationSnapshot
+{
+public:
+  static void WriteU32 (std::ostream &os, uint32_t value);
+  static uint32_t ReadU32 (std::istream &is);
+  static void WriteU64 (std::ostream &os, uint64_t value);
+  static uint64_t ReadU64 (std::istream &is);
+  static void WriteDouble (std::ostream &os, double value);
+  static double ReadDouble (std::istream &is);
+  static void WriteString (std::ostream &os, const std::string &value);
+  static std::string ReadString (std::istream &is);
+  /// Write the id of the node the mobility model is aggregated to
+  static void WriteMobility (std::ostream &os, Ptr<const MobilityModel> mobility);
+  /// \returns the mobility model of the node whose id is read
+  static Ptr<MobilityModel> ReadMobility (std::istream &is);
+};
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Records the position of a random variable stream
+ *
+ * The state of an ns-3 RngStream cannot be read, so a model records how
+ * many values it drew from each of its variables, and a restore draws and
+ * discards as many values from a freshly assigned stream. A restore thus
+ * replays every draw made since the streams were assigned, usually since
+ * t=0: its cost grows linearly with the simulated time at which the
+ * snapshot was taken, and restoring the snapshot of a week-long run takes
+ * as many draws as the whole week did.
+ *
+ * Variables whose number of underlying uniforms depends on a parameter
+ * (the shape of a Gamma or Erlang variable) record that parameter too.
+ * An ordered log keeps the draws run-length encoded, a run of draws with
+ * the same parameter costing one entry, because the uniforms consumed by
+ * a rejection sampler (Gamma) depend on the order of the parameters. It
+ * is unbounded: a variable whose parameter keeps changing, such as the
+ * Gamma variable of a NakagamiPropagationLossModel with links on both
+ * sides of Distance1, adds an entry, and from time to time an
+ * allocation, per change. An unordered log keeps one total per
+ * parameter, which is enough when a draw consumes a number of uniforms
+ * fixed by its parameter (Erlang).
+ */
+class RandomDrawLog
+{
+public:
+  /// \param ordered whether the stream position depends on the order of the parameters
+  RandomDrawLog (bool ordered = true);
+  /// Record count draws made with the given parameter
+  void Record (double parameter = 0, uint64_t count = 1)
+  {
+    if (m_runs.empty () || m_runs.back ().first != parameter)
+      {
+        StartRun (parameter);
+      }
+    m_runs.back ().second += count;
+  }
+  /// \returns the number of runs of draws with the same parameter
+  uint32_t GetNRuns (void) const;
+  /// \returns the parameter of run i
+  double GetParameter (uint32_t i) const;
+  /// \returns the number of draws of run i
+  uint64_t GetCount (uint32_t i) const;
+  /// \returns the total number of draws
+  uint64_t GetNDraws (void) const;
+  void Clear (void);
+  void Write (std::ostream &os) const;
+  void Read (std::istream &is);
+private:
+  /// Make the run of parameter the last one
+  void StartRun (double parameter);
+
+  std::vector<std::pair<double, uint64_t> > m_runs;
+  bool m_ordered;
+};
+
+} // namespace ns3
+
+#endif /* PROPAGATION_SNAPSHOT_H */
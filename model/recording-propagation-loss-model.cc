@@ -0,0 +1,237 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "recording-propagation-loss-model.h"
+#include "propagation-snapshot.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/abort.h"
+#include "ns3/mobility-model.h"
+
+NS_LOG_COMPONENT_DEFINE ("RecordingPropagationLossModel");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (RecordingPropagationLossModel);
+
+/// Magic string at the start of a trace
+static const char *g_traceMagic = "ns3-propagation-trace";
+
+const uint32_t RecordingPropagationLossModel::TRACE_VERSION;
+
+TypeId
+RecordingPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::RecordingPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .AddConstructor<RecordingPropagationLossModel> ()
+    .AddAttribute ("FileName",
+                   "The file receiving the trace of the calls.",
+                   StringValue ("propagation.trace"),
+                   MakeStringAccessor (&RecordingPropagationLossModel::SetFileName,
+                                       &RecordingPropagationLossModel::GetFileName),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+RecordingPropagationLossModel::RecordingPropagationLossModel ()
+  : m_nCalls (0)
+{
+}
+
+RecordingPropagationLossModel::~RecordingPropagationLossModel ()
+{
+  Close ();
+}
+
+void
+RecordingPropagationLossModel::DoDispose (void)
+{
+  Close ();
+  m_indices.clear ();
+  PropagationLossModel::DoDispose ();
+}
+
+void
+RecordingPropagationLossModel::SetFileName (std::string fileName)
+{
+  NS_ABORT_MSG_IF (m_os.is_open (), "The trace " << m_fileName << " is already being written");
+  m_fileName = fileName;
+}
+
+std::string
+RecordingPropagationLossModel::GetFileName (void) const
+{
+  return m_fileName;
+}
+
+void
+RecordingPropagationLossModel::Close (void)
+{
+  if (m_os.is_open ())
+    {
+      NS_LOG_INFO ("Recorded " << m_nCalls << " calls of " << m_positions.size ()
+                               << " mobility models to " << m_fileName);
+      m_os.close ();
+    }
+}
+
+uint64_t
+RecordingPropagationLossModel::GetNCalls (void) const
+{
+  return m_nCalls;
+}
+
+uint32_t
+RecordingPropagationLossModel::GetNMobilityModels (void) const
+{
+  return m_positions.size ();
+}
+
+uint32_t
+RecordingPropagationLossModel::GetIndex (Ptr<MobilityModel> mobility) const
+{
+  std::map<Ptr<MobilityModel>, uint32_t>::const_iterator it = m_indices.find (mobility);
+  Vector position = mobility->GetPosition ();
+  uint32_t index;
+  if (it == m_indices.end ())
+    {
+      index = m_positions.size ();
+      m_indices[mobility] = index;
+      m_positions.push_back (position);
+    }
+  else
+    {
+      index = it->second;
+      const Vector &last = m_positions[index];
+      if (last.x == position.x && last.y == position.y && last.z == position.z)
+        {
+          return index;
+        }
+      m_positions[index] = position;
+    }
+  m_os.put (static_cast<char> (RECORD_POSITION));
+  PropagationSnapshot::WriteU32 (m_os, index);
+  PropagationSnapshot::WriteDouble (m_os, position.x);
+  PropagationSnapshot::WriteDouble (m_os, position.y);
+  PropagationSnapshot::WriteDouble (m_os, position.z);
+  return index;
+}
+
+void
+RecordingPropagationLossModel::Record (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  if (!m_os.is_open ())
+    {
+      NS_ABORT_MSG_IF (m_nCalls > 0, "The trace " << m_fileName << " was closed");
+      m_os.open (m_fileName.c_str (), std::ios::binary);
+      NS_ABORT_MSG_UNLESS (m_os, "Could not open " << m_fileName);
+      PropagationSnapshot::WriteString (m_os, g_traceMagic);
+      PropagationSnapshot::WriteU32 (m_os, TRACE_VERSION);
+      PropagationSnapshot::WriteU64 (m_os, Seconds (1.0).GetTimeStep ());
+    }
+  uint32_t tx = GetIndex (a);
+  uint32_t rx = GetIndex (b);
+  m_os.put (static_cast<char> (RECORD_CALL));
+  PropagationSnapshot::WriteU32 (m_os, tx);
+  PropagationSnapshot::WriteU32 (m_os, rx);
+  PropagationSnapshot::WriteU64 (m_os, GetEvaluationTime ().GetTimeStep ());
+  PropagationSnapshot::WriteDouble (m_os, txPowerDbm);
+  m_nCalls++;
+}
+
+double
+RecordingPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                              Ptr<MobilityModel> a,
+                                              Ptr<MobilityModel> b) const
+{
+  Record (txPowerDbm, a, b);
+  return txPowerDbm;
+}
+
+double
+RecordingPropagationLossModel::DoCalcRxPowerW (double txPowerW,
+                                               Ptr<MobilityModel> a,
+                                               Ptr<MobilityModel> b) const
+{
+  Record (WToDbm (txPowerW), a, b);
+  return txPowerW;
+}
+
+PropagationLossModel::PowerDomain
+RecordingPropagationLossModel::GetPowerDomain (void) const
+{
+  return DOMAIN_ANY;
+}
+
+double
+RecordingPropagationLossModel::GetMaxGainDb (void) const
+{
+  return 0;
+}
+
+int64_t
+RecordingPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+void
+PropagationTraceReader::Open (std::string fileName)
+{
+  m_is.open (fileName.c_str (), std::ios::binary);
+  NS_ABORT_MSG_UNLESS (m_is, "Could not open " << fileName);
+  NS_ABORT_MSG_UNLESS (PropagationSnapshot::ReadString (m_is) == g_traceMagic,
+                       fileName << " is not a propagation trace");
+  uint32_t version = PropagationSnapshot::ReadU32 (m_is);
+  NS_ABORT_MSG_UNLESS (version == RecordingPropagationLossModel::TRACE_VERSION,
+                       "Unsupported version " << version << " of trace " << fileName);
+  uint64_t stepsPerSecond = PropagationSnapshot::ReadU64 (m_is);
+  NS_ABORT_MSG_UNLESS (stepsPerSecond == static_cast<uint64_t> (Seconds (1.0).GetTimeStep ()),
+                       fileName << " was recorded with another time resolution");
+}
+
+bool
+PropagationTraceReader::Read (PropagationTraceRecord &record)
+{
+  int type = m_is.get ();
+  if (type == std::char_traits<char>::eof ())
+    {
+      return false;
+    }
+  record.m_type = static_cast<RecordingPropagationLossModel::RecordType> (type);
+  switch (type)
+    {
+    case RecordingPropagationLossModel::RECORD_POSITION:
+      record.m_index = PropagationSnapshot::ReadU32 (m_is);
+      record.m_position.x = PropagationSnapshot::ReadDouble (m_is);
+      record.m_position.y = PropagationSnapshot::ReadDouble (m_is);
+      record.m_position.z = PropagationSnapshot::ReadDouble (m_is);
+      break;
+    case RecordingPropagationLossModel::RECORD_CALL:
+      record.m_tx = PropagationSnapshot::ReadU32 (m_is);
+      record.m_rx = PropagationSnapshot::ReadU32 (m_is);
+      record.m_timeStep = PropagationSnapshot::ReadU64 (m_is);
+      record.m_txPowerDbm = PropagationSnapshot::ReadDouble (m_is);
+      break;
+    default:
+      NS_FATAL_ERROR ("Corrupted propagation trace, record type " << type);
+    }
+  return true;
+}
+
+} // namespace ns3
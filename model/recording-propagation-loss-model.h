@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef RECORDING_PROPAGATION_LOSS_MODEL_H
+#define RECORDING_PROPAGATION_LOSS_MODEL_H
+
+#include "ns3/propagation-loss-model.h"
+#include "ns3/vector.h"
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Records the calls of a chain into a binary trace
+ *
+ * Placed first in a chain, this model writes every call to FileName:
+ * the transmitter and receiver indices, the simulation time and the
+ * transmission power. It does not change the power, so the chained
+ * models see the same calls as without it:
+ * \code
+ *   Ptr<RecordingPropagationLossModel> recorder = CreateObject<RecordingPropagationLossModel> ();
+ *   recorder->SetAttribute ("FileName", StringValue ("channel.trace"));
+ *   recorder->SetNext (CreateObject<LogDistancePropagationLossModel> ());
+ * \endcode
+ *
+ * The mobility models are numbered in the order of their first call. The
+ * position of a mobility model is written before the first call that
+ * sees it at a new position, so the trace can be replayed without the
+ * simulation that produced it, see PropagationTraceReader and the
+ * propagation-replay-bench example.
+ *
+ * The trace is written in host byte order, as the snapshots of
+ * PropagationSnapshot, and is complete once the model is disposed or
+ * destroyed, or after Close.
+ */
+class RecordingPropagationLossModel : public PropagationLossModel
+{
+public:
+  static TypeId GetTypeId (void);
+  RecordingPropagationLossModel ();
+  virtual ~RecordingPropagationLossModel ();
+
+  void SetFileName (std::string fileName);
+  std::string GetFileName (void) const;
+  /// Write the pending records and close the trace
+  void Close (void);
+
+  /// \returns the number of calls recorded
+  uint64_t GetNCalls (void) const;
+  /// \returns the number of mobility models seen
+  uint32_t GetNMobilityModels (void) const;
+
+  /// \returns 0: the model does not change the power, so it does not stop
+  /// a cutoff from skipping the models around it
+  virtual double GetMaxGainDb (void) const;
+
+  /// The record types of a trace
+  enum RecordType
+  {
+    /// the position of a mobility model
+    RECORD_POSITION = 'P',
+    /// a call of the chain
+    RECORD_CALL = 'C'
+  };
+  /// Version of the trace format
+  static const uint32_t TRACE_VERSION = 1;
+
+private:
+  RecordingPropagationLossModel (const RecordingPropagationLossModel &o);
+  RecordingPropagationLossModel & operator = (const RecordingPropagationLossModel &o);
+
+  virtual void DoDispose (void);
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual double DoCalcRxPowerW (double txPowerW,
+                                 Ptr<MobilityModel> a,
+                                 Ptr<MobilityModel> b) const;
+  virtual PowerDomain GetPowerDomain (void) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  /// Write the call a->b, opening the trace on the first call
+  void Record (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+  /// \returns the index of mobility, writing its position if it changed
+  uint32_t GetIndex (Ptr<MobilityModel> mobility) const;
+
+  std::string m_fileName;
+  mutable std::ofstream m_os;
+  mutable uint64_t m_nCalls;
+  /// Index of each mobility model seen
+  mutable std::map<Ptr<MobilityModel>, uint32_t> m_indices;
+  /// Last position written for each index
+  mutable std::vector<Vector> m_positions;
+};
+
+/**
+ * \ingroup propagation
+ *
+ * \brief A record of a trace written by RecordingPropagationLossModel
+ */
+struct PropagationTraceRecord
+{
+  /// RECORD_POSITION or RECORD_CALL
+  RecordingPropagationLossModel::RecordType m_type;
+  /// Index of the mobility model of a position record
+  uint32_t m_index;
+  /// Position of a position record
+  Vector m_position;
+  /// Indices of the transmitter and receiver of a call record
+  uint32_t m_tx;
+  uint32_t m_rx;
+  /// Time of a call record, in time steps
+  int64_t m_timeStep;
+  /// Transmission power of a call record (dBm)
+  double m_txPowerDbm;
+};
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Reads a trace written by RecordingPropagationLossModel
+ *
+ * The trace must have been recorded with the time resolution of the
+ * reader; Open aborts otherwise.
+ */
+class PropagationTraceReader
+{
+public:
+  /// Open fileName and read its header
+  void Open (std::string fileName);
+  /**
+   * \param record receives the next record
+   * \returns false at the end of the trace
+   */
+  bool Read (PropagationTraceRecord &record);
+private:
+  std::ifstream m_is;
+};
+
+} // namespace ns3
+
+#endif /* RECORDING_PROPAGATION_LOSS_MODEL_H */
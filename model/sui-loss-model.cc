@@ -64,10 +64,13 @@
 
 #include "ns3/propagation-loss-model.h"
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "ns3/mobility-model.h"
 #include "ns3/double.h"
 #include "ns3/enum.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
 #include <cmath>
 #include "sui-loss-model.h"
 #include "ns3/random-variable-stream.h"
@@ -123,12 +126,48 @@ SUIPathLossModel::GetTypeId (void)
 				  "Enable/Disable Shadowing (s), use 1/0 to enable/disable (default is 1).",
 				   DoubleValue (1),
 				   MakeDoubleAccessor (&SUIPathLossModel::m_shadowing),
-				   MakeDoubleChecker<double> ());
+				   MakeDoubleChecker<double> ())
+
+	.AddAttribute ("FreezeShadowing",
+				  "Draw the path loss exponent and shadowing of a link once and reuse them on later calls (default is false).",
+				   BooleanValue (false),
+				   MakeBooleanAccessor (&SUIPathLossModel::SetFreezeShadowing,
+				                        &SUIPathLossModel::GetFreezeShadowing),
+				   MakeBooleanChecker ())
+
+	.AddAttribute ("CounterBasedStreams",
+				  "Draw x, y and z from per-link counter-based sequences, independent of the evaluation order (default is false).",
+				   BooleanValue (false),
+				   MakeBooleanAccessor (&SUIPathLossModel::m_counterBased),
+				   MakeBooleanChecker ())
+
+	.AddAttribute ("ExponentRv",
+				  "Access to the NormalRandomVariable x of the path loss exponent",
+				   StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0]"),
+				   MakePointerAccessor (&SUIPathLossModel::m_xVariable),
+				   MakePointerChecker<NormalRandomVariable> ())
+
+	.AddAttribute ("ShadowingRv",
+				  "Access to the NormalRandomVariable y of the shadowing",
+				   StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0]"),
+				   MakePointerAccessor (&SUIPathLossModel::m_yVariable),
+				   MakePointerChecker<NormalRandomVariable> ())
+
+	.AddAttribute ("ShadowingSigmaRv",
+				  "Access to the NormalRandomVariable z of the shadowing standard deviation",
+				   StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0]"),
+				   MakePointerAccessor (&SUIPathLossModel::m_zVariable),
+				   MakePointerChecker<NormalRandomVariable> ());
 
   return tid;
 }
 
 SUIPathLossModel::SUIPathLossModel ()
+  : m_freezeShadowing (false),
+    m_counterBased (false),
+    m_xDraws (0),
+    m_yDraws (0),
+    m_zDraws (0)
 {
 }
 
@@ -203,37 +242,86 @@ SUIPathLossModel::GetEnvironment (void) const
   return m_environment;
 }
 
-double
-SUIPathLossModel::GetLoss (Ptr<MobilityModel> x, Ptr<MobilityModel> y) const
+void
+SUIPathLossModel::SetFreezeShadowing (bool freeze)
 {
-	double mean = 0.0;
-	double variance = 1.0;
-	
-	// Use NS_GLOBAL_VALUE="RngRun=20" from terminal to change the seed for RNG from default 1 to 20. 
-	// Ex: $ NS_GLOBAL_VALUE="RngRun=20"  ./waf --run scratch/file-name
-	Ptr<NormalRandomVariable> randx = CreateObject<NormalRandomVariable> ();
-	Ptr<NormalRandomVariable> randy = CreateObject<NormalRandomVariable> ();
-	Ptr<NormalRandomVariable> randz = CreateObject<NormalRandomVariable> ();
+  m_freezeShadowing = freeze;
+  m_frozen.Clear ();
+}
 
-	randx->SetAttribute ("Mean", DoubleValue (mean));
-	randx->SetAttribute ("Variance", DoubleValue (variance));
-	
-	randy->SetAttribute ("Mean", DoubleValue (mean));
-	randy->SetAttribute ("Variance", DoubleValue (variance));
-	
-	randz->SetAttribute ("Mean", DoubleValue (mean));
-	randz->SetAttribute ("Variance", DoubleValue (variance));
-	
-	double m_x = randx->GetValue ();
-	double m_y = randy->GetValue ();
-	double m_z = randz->GetValue ();
+bool
+SUIPathLossModel::GetFreezeShadowing (void) const
+{
+  return m_freezeShadowing;
+}
 
-	double distance = x->GetDistanceFrom (y);
+uint64_t
+SUIPathLossModel::GetNLinks (void) const
+{
+  return static_cast<uint64_t> (m_frozen.GetN ()) + m_rng.GetNLinks ();
+}
+
+SUIPathLossModel::ShadowingDraw
+SUIPathLossModel::GetShadowingDraw (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  ShadowingDraw draw;
+  draw.m_x = 0;
+  draw.m_y = 0;
+  draw.m_z = 0;
+  // Enable/Disable Shadowing
+  if (m_shadowing == 0)
+    {
+      return draw;
+    }
+  if (m_freezeShadowing)
+    {
+      ShadowingDraw *frozen = m_frozen.GetPathData (a, b, 0);
+      if (frozen != 0)
+        {
+          return *frozen;
+        }
+    }
+  if (m_counterBased)
+    {
+      double normals[3];
+      m_rng.SeekLink (a, b);
+      m_rng.GetNormals (normals, 3);
+      draw.m_x = m_xVariable->GetMean () + std::sqrt (m_xVariable->GetVariance ()) * normals[0];
+      draw.m_y = m_yVariable->GetMean () + std::sqrt (m_yVariable->GetVariance ()) * normals[1];
+      draw.m_z = m_zVariable->GetMean () + std::sqrt (m_zVariable->GetVariance ()) * normals[2];
+    }
+  else
+    {
+      draw.m_x = m_xVariable->GetValue ();
+      draw.m_y = m_yVariable->GetValue ();
+      draw.m_z = m_zVariable->GetValue ();
+      m_xDraws++;
+      m_yDraws++;
+      m_zDraws++;
+    }
+  if (m_freezeShadowing)
+    {
+      m_frozen.AddPathData (draw, a, b, 0);
+    }
+  return draw;
+}
+
+double
+SUIPathLossModel::GetLoss (Ptr<MobilityModel> x, Ptr<MobilityModel> y) const
+{
+	double distance = GetDistance (x, y);
 	double distance_m = distance; //  for distance in m
 	if (distance_m < m_minDistance)
     {
       return 0.0;
     }
+
+	// Use NS_GLOBAL_VALUE="RngRun=20" from terminal to change the seed for RNG from default 1 to 20. 
+	// Ex: $ NS_GLOBAL_VALUE="RngRun=20"  ./waf --run scratch/file-name
+	ShadowingDraw draw = GetShadowingDraw (x, y);
+	double m_x = draw.m_x;
+	double m_y = draw.m_y;
+	double m_z = draw.m_z;
   
 	double d0 = 100; // d0 is defined as 100m.
 	
@@ -262,13 +350,6 @@ SUIPathLossModel::GetLoss (Ptr<MobilityModel> x, Ptr<MobilityModel> y) const
 	a = 3.6; b = 0.005;  c = 20.0; sigma_gamma = 0.59; mu_sigma = 8.2; sigma_sigma = 1.6;
   	}
 
-		// Enable/Disable Shadowing
-		if (m_shadowing == 0)
-		{
-			m_x = 0;
-			m_y = 0;
-		}
-		
 		double m_gamma = a - (b*m_txheight) + (c/m_txheight) + (m_x * sigma_gamma);
 		double s = m_y * (mu_sigma + (m_z * sigma_sigma));
 		
@@ -312,7 +393,65 @@ SUIPathLossModel::DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<Mo
 int64_t
 SUIPathLossModel::DoAssignStreams (int64_t stream)
 {
-  return 0;
+  m_xVariable->SetStream (stream);
+  m_yVariable->SetStream (stream + 1);
+  m_zVariable->SetStream (stream + 2);
+  m_rng.SetStream (stream);
+  return 3;
+}
+
+void
+SUIPathLossModel::DoSerialize (std::ostream &os) const
+{
+  PropagationSnapshot::WriteU64 (os, m_xDraws);
+  PropagationSnapshot::WriteU64 (os, m_yDraws);
+  PropagationSnapshot::WriteU64 (os, m_zDraws);
+  PropagationSnapshot::WriteU32 (os, m_frozen.GetN ());
+  for (PropagationArena<ShadowingDraw>::Iterator it = m_frozen.Begin (); it != m_frozen.End (); ++it)
+    {
+      const ShadowingDraw &draw = m_frozen.Get (it->second);
+      PropagationSnapshot::WriteMobility (os, it->first.m_srcMobility);
+      PropagationSnapshot::WriteMobility (os, it->first.m_dstMobility);
+      PropagationSnapshot::WriteDouble (os, draw.m_x);
+      PropagationSnapshot::WriteDouble (os, draw.m_y);
+      PropagationSnapshot::WriteDouble (os, draw.m_z);
+    }
+  m_rng.Write (os);
+}
+
+void
+SUIPathLossModel::DoDeserialize (std::istream &is)
+{
+  NS_ABORT_MSG_IF (m_xDraws != 0 || m_yDraws != 0 || m_zDraws != 0,
+                   "A snapshot can only be restored into an unused SUIPathLossModel");
+  uint64_t xDraws = PropagationSnapshot::ReadU64 (is);
+  uint64_t yDraws = PropagationSnapshot::ReadU64 (is);
+  uint64_t zDraws = PropagationSnapshot::ReadU64 (is);
+  for (; m_xDraws < xDraws; m_xDraws++)
+    {
+      m_xVariable->GetValue ();
+    }
+  for (; m_yDraws < yDraws; m_yDraws++)
+    {
+      m_yVariable->GetValue ();
+    }
+  for (; m_zDraws < zDraws; m_zDraws++)
+    {
+      m_zVariable->GetValue ();
+    }
+  m_frozen.Clear ();
+  uint32_t n = PropagationSnapshot::ReadU32 (is);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<MobilityModel> a = PropagationSnapshot::ReadMobility (is);
+      Ptr<MobilityModel> b = PropagationSnapshot::ReadMobility (is);
+      ShadowingDraw draw;
+      draw.m_x = PropagationSnapshot::ReadDouble (is);
+      draw.m_y = PropagationSnapshot::ReadDouble (is);
+      draw.m_z = PropagationSnapshot::ReadDouble (is);
+      m_frozen.AddPathData (draw, a, b, 0);
+    }
+  m_rng.Read (is);
 }
 
 }
@@ -24,6 +24,8 @@
 
 #include "ns3/nstime.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-cache.h"
+#include "ns3/counter-based-rng.h"
 
 namespace ns3 {
 
@@ -61,18 +63,51 @@ public:
   void SetMinDistance (double minDistance);
   double GetMinDistance (void) const;
 
+  /**
+   * \param freeze true to draw the path loss exponent and shadowing of a
+   * link on its first call only, and reuse them on later calls
+   */
+  void SetFreezeShadowing (bool freeze);
+  bool GetFreezeShadowing (void) const;
+
+  /// \returns the number of frozen links and link sequences
+  virtual uint64_t GetNLinks (void) const;
+
 private:
   virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual void DoSerialize (std::ostream &os) const;
+  virtual void DoDeserialize (std::istream &is);
   
   double GetLoss (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
 
+  /// The N(0,1) variates x, y and z of a path loss computation
+  struct ShadowingDraw
+  {
+    double m_x;
+    double m_y;
+    double m_z;
+  };
+  /// \returns the variates of the link a<-->b, all zero if shadowing is disabled
+  ShadowingDraw GetShadowingDraw (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
   double m_txheight; 			// in meter
   double m_rxheight;			// in meter
   Environment m_environment;
   double m_minDistance;			// in meter
   double m_frequency;			// frequency in GHz  
   double m_shadowing;			// Enable/Disable Shadowing
+  bool m_freezeShadowing;
+  bool m_counterBased;
+  mutable CounterBasedRng m_rng;
+  Ptr<NormalRandomVariable> m_xVariable;
+  Ptr<NormalRandomVariable> m_yVariable;
+  Ptr<NormalRandomVariable> m_zVariable;
+  /// Draws of every link when m_freezeShadowing is set
+  mutable PropagationArena<ShadowingDraw> m_frozen;
+  mutable uint64_t m_xDraws;
+  mutable uint64_t m_yDraws;
+  mutable uint64_t m_zDraws;
 };
 
 }
@@ -0,0 +1,742 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/enum.h"
+#include "ns3/jakes-propagation-loss-model.h"
+#include "ns3/filtered-gaussian-fading-process.h"
+#include "ns3/jakes-fading-trace.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/simulator.h"
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <limits>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("JakesFadingTest");
+
+/// Bessel function of the first kind of order 0, by Simpson integration of
+/// \f$ J_0(x) = \frac{1}{\pi} \int_0^\pi \cos(x \sin \theta) d\theta \f$
+static double
+BesselJ0 (double x)
+{
+  const unsigned int n = 400;
+  const double h = JakesPropagationLossModel::PI / n;
+  double sum = 1 + std::cos (x * std::sin (JakesPropagationLossModel::PI));
+  for (unsigned int i = 1; i < n; i++)
+    {
+      sum += (i % 2 ? 4 : 2) * std::cos (x * std::sin (i * h));
+    }
+  return sum * h / 3 / JakesPropagationLossModel::PI;
+}
+
+// ===========================================================================
+// The power of Rayleigh fading with the Clarke/Jakes Doppler spectrum has
+// the normalized autocovariance J_0^2 (2 pi f_d tau). This is the check of
+// the R script of jakes-propagation-model-example, applied to the
+// filtered Gaussian engine.
+// ===========================================================================
+class FilteredGaussianAutocorrelationTestCase : public TestCase
+{
+public:
+  FilteredGaussianAutocorrelationTestCase ();
+  virtual ~FilteredGaussianAutocorrelationTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FilteredGaussianAutocorrelationTestCase::FilteredGaussianAutocorrelationTestCase ()
+  : TestCase ("Check the autocorrelation of the filtered Gaussian fading engine against J0^2")
+{
+}
+
+FilteredGaussianAutocorrelationTestCase::~FilteredGaussianAutocorrelationTestCase ()
+{
+}
+
+void
+FilteredGaussianAutocorrelationTestCase::DoRun (void)
+{
+  const double dopplerFrequencyHz = 80;
+  const double interval = 0.0002;
+  const uint32_t nSamples = 16384;
+  const uint32_t nLinks = 16;
+  const uint32_t maxLag = 200;
+  const uint32_t lagStep = 10;
+  Config::SetDefault ("ns3::FilteredGaussianFadingProcess::DopplerFrequencyHz", DoubleValue (dopplerFrequencyHz));
+  Config::SetDefault ("ns3::FilteredGaussianFadingProcess::SampleInterval", TimeValue (Seconds (interval)));
+  Config::SetDefault ("ns3::FilteredGaussianFadingProcess::NumberOfSamples", UintegerValue (nSamples));
+
+  Ptr<JakesPropagationLossModel> jakes = CreateObject<JakesPropagationLossModel> ();
+  jakes->SetAttribute ("FadingEngine", EnumValue (JakesPropagationLossModel::FilteredGaussian));
+  jakes->AssignStreams (1);
+
+  std::vector<double> autocorrelation (maxLag / lagStep + 1, 0);
+  double meanPower = 0;
+  std::vector<double> power (nSamples);
+  for (uint32_t link = 0; link < nLinks; link++)
+    {
+      Ptr<FilteredGaussianFadingProcess> process = CreateObject<FilteredGaussianFadingProcess> ();
+      process->SetPropagationLossModel (jakes);
+      double mean = 0;
+      for (uint32_t n = 0; n < nSamples; n++)
+        {
+          power[n] = std::norm (process->GetSample (n)) / 2;
+          mean += power[n];
+        }
+      mean /= nSamples;
+      meanPower += mean / nLinks;
+      // the block is cyclic, so is the autocovariance
+      double variance = 0;
+      for (uint32_t n = 0; n < nSamples; n++)
+        {
+          variance += (power[n] - mean) * (power[n] - mean);
+        }
+      for (uint32_t i = 0; i < autocorrelation.size (); i++)
+        {
+          double covariance = 0;
+          for (uint32_t n = 0; n < nSamples; n++)
+            {
+              covariance += (power[n] - mean) * (power[(n + i * lagStep) % nSamples] - mean);
+            }
+          autocorrelation[i] += covariance / variance / nLinks;
+        }
+      process->Dispose ();
+    }
+
+  NS_TEST_EXPECT_MSG_EQ_TOL (meanPower, 1.0, 0.1, "Got unexpected mean power gain");
+  for (uint32_t i = 0; i < autocorrelation.size (); i++)
+    {
+      double tau = i * lagStep * interval;
+      double j0 = BesselJ0 (2 * JakesPropagationLossModel::PI * dopplerFrequencyHz * tau);
+      NS_TEST_EXPECT_MSG_EQ_TOL (autocorrelation[i], j0 * j0, 0.05, "Got unexpected autocorrelation at lag " << tau << "s");
+    }
+
+  // the engine is reachable through JakesPropagationLossModel
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  double first = jakes->CalcRxPower (0, a, b);
+  NS_TEST_EXPECT_MSG_EQ (jakes->CalcRxPower (0, b, a), first, "Fading of a link is not symmetric");
+  Simulator::Destroy ();
+}
+
+// ===========================================================================
+// The channel matrix shares the oscillators of the single antenna gain: its
+// first element must equal that gain, every element must have unit mean
+// power, and adjacent receive antennas must show the configured correlation.
+// ===========================================================================
+class JakesChannelMatrixTestCase : public TestCase
+{
+public:
+  JakesChannelMatrixTestCase ();
+  virtual ~JakesChannelMatrixTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+JakesChannelMatrixTestCase::JakesChannelMatrixTestCase ()
+  : TestCase ("Check the Jakes channel matrix and its Kronecker correlation")
+{
+}
+
+JakesChannelMatrixTestCase::~JakesChannelMatrixTestCase ()
+{
+}
+
+void
+JakesChannelMatrixTestCase::DoRun (void)
+{
+  const uint32_t nLinks = 2000;
+  const double rho = 0.7;
+  Ptr<JakesPropagationLossModel> jakes = CreateObject<JakesPropagationLossModel> ();
+  jakes->AssignStreams (1);
+
+  std::vector<std::complex<double> > h;
+  double power[4] = { 0, 0, 0, 0 };
+  std::complex<double> correlation (0, 0);
+  for (uint32_t link = 0; link < nLinks; link++)
+    {
+      Ptr<JakesProcess> process = CreateObject<JakesProcess> ();
+      process->SetAttribute ("NumberOfTxAntennas", UintegerValue (2));
+      process->SetAttribute ("NumberOfRxAntennas", UintegerValue (2));
+      process->SetAttribute ("RxCorrelation", DoubleValue (rho));
+      process->SetPropagationLossModel (jakes);
+      Time at = Seconds (0.001 * link);
+      process->GetChannelMatrix (at, h);
+      NS_TEST_ASSERT_MSG_EQ (h.size (), 4, "Got unexpected matrix size");
+      NS_TEST_EXPECT_MSG_EQ_TOL (std::abs (h[0] - process->GetComplexGain (at)), 0, 1e-12,
+                                 "First element differs from the single antenna gain");
+      for (uint32_t e = 0; e < 4; e++)
+        {
+          power[e] += std::norm (h[e]) / 2 / nLinks;
+        }
+      // receive antennas 0 and 1 of transmit antenna 0
+      correlation += h[0] * std::conj (h[2]) / 2.0 / static_cast<double> (nLinks);
+      process->Dispose ();
+    }
+  for (uint32_t e = 0; e < 4; e++)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (power[e], 1.0, 0.1, "Got unexpected mean power of element " << e);
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (correlation.real (), rho, 0.1, "Got unexpected receive correlation");
+  Simulator::Destroy ();
+}
+
+// ===========================================================================
+// TraceFilename: every link reads the shared trace from its own offset,
+// drawn once from the first stream of the model. The offsets are
+// reproduced with a variable on the same stream, and the gains at times
+// between the samples are compared with the linear interpolation of the
+// samples the trace was written from.
+// ===========================================================================
+class JakesTraceTestCase : public TestCase
+{
+public:
+  JakesTraceTestCase ();
+  virtual ~JakesTraceTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /// \returns the gain [dB] at t seconds from the start of the cyclic samples
+  double GetExpectedGainDb (double t) const;
+
+  std::vector<std::complex<double> > m_samples;
+  double m_interval;
+};
+
+JakesTraceTestCase::JakesTraceTestCase ()
+  : TestCase ("Check that JakesPropagationLossModel reads a fading trace from a fixed offset per link"),
+    m_interval (0.001)
+{
+}
+
+JakesTraceTestCase::~JakesTraceTestCase ()
+{
+}
+
+double
+JakesTraceTestCase::GetExpectedGainDb (double t) const
+{
+  double position = std::fmod (t / m_interval, static_cast<double> (m_samples.size ()));
+  uint32_t i = static_cast<uint32_t> (position);
+  uint32_t j = (i + 1) % m_samples.size ();
+  double w = position - i;
+  std::complex<double> gain = m_samples[i] + w * (m_samples[j] - m_samples[i]);
+  return 10 * std::log10 (std::norm (gain) / 2);
+}
+
+void
+JakesTraceTestCase::DoRun (void)
+{
+  const uint32_t nSamples = 1000;
+  Ptr<JakesPropagationLossModel> generator = CreateObject<JakesPropagationLossModel> ();
+  generator->AssignStreams (5);
+  Ptr<JakesProcess> process = CreateObject<JakesProcess> ();
+  process->SetPropagationLossModel (generator);
+  std::string filename = CreateTempDirFilename ("jakes-model.trace");
+  JakesFadingTrace::Write (filename, process, Seconds (m_interval), nSamples, 80, 20);
+  for (uint32_t n = 0; n < nSamples; n++)
+    {
+      // the trace holds single precision samples
+      std::complex<double> gain = process->GetComplexGain (Seconds (m_interval * n));
+      m_samples.push_back (std::complex<double> (static_cast<float> (gain.real ()), static_cast<float> (gain.imag ())));
+    }
+  process->Dispose ();
+  double duration = nSamples * m_interval;
+
+  Ptr<JakesPropagationLossModel> jakes = CreateObject<JakesPropagationLossModel> ();
+  jakes->SetAttribute ("TraceFilename", StringValue (filename));
+  jakes->AssignStreams (1);
+  // the offsets of the first two links, drawn as the model does
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  uniform->SetAttribute ("Min", DoubleValue (-JakesPropagationLossModel::PI));
+  uniform->SetAttribute ("Max", DoubleValue (JakesPropagationLossModel::PI));
+  uniform->SetStream (1);
+  double offsets[2];
+  for (uint32_t l = 0; l < 2; l++)
+    {
+      offsets[l] = (uniform->GetValue () + JakesPropagationLossModel::PI) / (2 * JakesPropagationLossModel::PI) * duration;
+    }
+  NS_TEST_EXPECT_MSG_NE (offsets[0], offsets[1], "Two links should read the trace from different offsets");
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> c = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> links[2][2] = { { a, b }, { a, c } };
+  // between the samples, and beyond the duration of the trace
+  const double times[] = { 0.0025, 0.0173, 0.4441, 1.7306 };
+  std::vector<double> gain;
+  for (uint32_t round = 0; round < 2; round++)
+    {
+      for (uint32_t l = 0; l < 2; l++)
+        {
+          for (uint32_t i = 0; i < sizeof (times) / sizeof (times[0]); i++)
+            {
+              jakes->Sample (0, links[l][0], links[l][1], Seconds (times[i]), Seconds (0), 1, gain);
+              NS_TEST_EXPECT_MSG_EQ_TOL (gain[0], GetExpectedGainDb (times[i] + offsets[l]), 1e-4,
+                                         "Link " << l << " differs from the trace at " << times[i] << " s, round " << round);
+            }
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (jakes->GetNLinks (), 2, "Got unexpected number of trace offsets");
+  Simulator::Destroy ();
+}
+
+// ===========================================================================
+// CoherenceTimeFraction: a gain is reused while less than fraction / f_d
+// elapsed since it was computed, recomputed after that or for an earlier
+// time, and the counters of computed and reused gains follow the calls.
+// The computed gains must equal those of a model without reuse.
+// ===========================================================================
+class JakesCoherenceReuseTestCase : public TestCase
+{
+public:
+  JakesCoherenceReuseTestCase ();
+  virtual ~JakesCoherenceReuseTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+JakesCoherenceReuseTestCase::JakesCoherenceReuseTestCase ()
+  : TestCase ("Check the reuse of Jakes gains within a fraction of the coherence time")
+{
+}
+
+JakesCoherenceReuseTestCase::~JakesCoherenceReuseTestCase ()
+{
+}
+
+void
+JakesCoherenceReuseTestCase::DoRun (void)
+{
+  // with the default f_d = 80 Hz, a gain is reused during 1.25 ms
+  const double fraction = 0.1;
+  Ptr<JakesPropagationLossModel> jakes = CreateObject<JakesPropagationLossModel> ();
+  jakes->SetAttribute ("CoherenceTimeFraction", DoubleValue (fraction));
+  jakes->AssignStreams (1);
+  Ptr<JakesPropagationLossModel> reference = CreateObject<JakesPropagationLossModel> ();
+  reference->AssignStreams (1);
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+
+  // time [ms], and whether the gain of the last computation is reused
+  const double times[] = { 10, 10.6, 11.2, 11.4, 11.3 };
+  const bool reused[] = { false, true, true, false, false };
+  std::vector<double> gain;
+  std::vector<double> expected;
+  double computedGain = 0;
+  uint64_t nComputed = 0;
+  uint64_t nReused = 0;
+  for (uint32_t i = 0; i < sizeof (times) / sizeof (times[0]); i++)
+    {
+      Time at = MicroSeconds (static_cast<uint64_t> (times[i] * 1000));
+      jakes->Sample (0, a, b, at, Seconds (0), 1, gain);
+      reference->Sample (0, a, b, at, Seconds (0), 1, expected);
+      if (reused[i])
+        {
+          NS_TEST_EXPECT_MSG_EQ (gain[0], computedGain, "The gain at " << times[i] << " ms should be reused");
+          nReused++;
+        }
+      else
+        {
+          NS_TEST_EXPECT_MSG_EQ_TOL (gain[0], expected[0], 1e-12, "The gain at " << times[i] << " ms should be computed");
+          computedGain = gain[0];
+          nComputed++;
+        }
+      NS_TEST_EXPECT_MSG_EQ (jakes->GetNumberOfComputedGains (), nComputed, "Wrong number of computed gains at " << times[i] << " ms");
+      NS_TEST_EXPECT_MSG_EQ (jakes->GetNumberOfReusedGains (), nReused, "Wrong number of reused gains at " << times[i] << " ms");
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (jakes->GetGainReuseRatio (), 0.4, 1e-12, "Got unexpected reuse ratio");
+  NS_TEST_EXPECT_MSG_EQ (reference->GetGainReuseRatio (), 0, "No gain should be reused without CoherenceTimeFraction");
+
+  jakes->ResetGainStatistics ();
+  NS_TEST_EXPECT_MSG_EQ (jakes->GetNumberOfComputedGains (), 0, "ResetGainStatistics should clear the computed gains");
+  NS_TEST_EXPECT_MSG_EQ (jakes->GetNumberOfReusedGains (), 0, "ResetGainStatistics should clear the reused gains");
+  NS_TEST_EXPECT_MSG_EQ (jakes->GetGainReuseRatio (), 0, "The reuse ratio without calls should be 0");
+  Simulator::Destroy ();
+}
+
+// ===========================================================================
+// The frequency response of a power delay profile: every subcarrier must
+// equal the direct sum of the tap gains, each rotated by its exact phase
+// e^(-j 2 pi f tau), the carrier must equal the time domain gain, and a
+// profile of a single tap must reduce to the flat model. The gain X_l of
+// tap l is obtained from a profile where only tap l has power: it draws
+// the same oscillators from the same stream.
+// ===========================================================================
+class JakesFrequencyResponseTestCase : public TestCase
+{
+public:
+  JakesFrequencyResponseTestCase ();
+  virtual ~JakesFrequencyResponseTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /// \returns a link of a model with the given profile, on stream 1
+  Ptr<JakesProcess> CreateProcess (const std::vector<double> &delays, const std::vector<double> &powersDb);
+};
+
+JakesFrequencyResponseTestCase::JakesFrequencyResponseTestCase ()
+  : TestCase ("Check the Jakes frequency response against a direct sum of the taps")
+{
+}
+
+JakesFrequencyResponseTestCase::~JakesFrequencyResponseTestCase ()
+{
+}
+
+Ptr<JakesProcess>
+JakesFrequencyResponseTestCase::CreateProcess (const std::vector<double> &delays, const std::vector<double> &powersDb)
+{
+  Ptr<JakesPropagationLossModel> jakes = CreateObject<JakesPropagationLossModel> ();
+  jakes->SetPowerDelayProfile (delays, powersDb);
+  jakes->AssignStreams (1);
+  Ptr<JakesProcess> process = CreateObject<JakesProcess> ();
+  process->SetPropagationLossModel (jakes);
+  return process;
+}
+
+void
+JakesFrequencyResponseTestCase::DoRun (void)
+{
+  const uint32_t nSubcarriers = 1201;
+  const uint32_t carrier = nSubcarriers / 2;
+  const double spacing = 15e3;
+  const double tapDelays[] = { 0, 0.3e-6, 1.1e-6, 2.5e-6, 5e-6 };
+  const double tapPowersDb[] = { 0, -2, -5, -9, -15 };
+  const uint32_t nTaps = sizeof (tapDelays) / sizeof (tapDelays[0]);
+  std::vector<double> delays (tapDelays, tapDelays + nTaps);
+  std::vector<double> powersDb (tapPowersDb, tapPowersDb + nTaps);
+  double totalPower = 0;
+  for (uint32_t l = 0; l < nTaps; l++)
+    {
+      totalPower += std::pow (10, powersDb[l] / 10);
+    }
+
+  Ptr<JakesProcess> process = CreateProcess (delays, powersDb);
+  std::vector<Ptr<JakesProcess> > taps;
+  for (uint32_t l = 0; l < nTaps; l++)
+    {
+      std::vector<double> single (l + 1, -std::numeric_limits<double>::infinity ());
+      single[l] = 0;
+      taps.push_back (CreateProcess (std::vector<double> (delays.begin (), delays.begin () + l + 1), single));
+    }
+
+  std::vector<std::complex<double> > response;
+  const double times[] = { 0, 0.0037, 0.25 };
+  for (uint32_t i = 0; i < sizeof (times) / sizeof (times[0]); i++)
+    {
+      Time at = Seconds (times[i]);
+      process->GetFrequencyResponse (at, nSubcarriers, spacing, response);
+      NS_TEST_ASSERT_MSG_EQ (response.size (), nSubcarriers, "Got unexpected number of subcarriers");
+      double maxError = 0;
+      for (uint32_t k = 0; k < nSubcarriers; k++)
+        {
+          double f = (static_cast<double> (k) - carrier) * spacing;
+          std::complex<double> expected (0, 0);
+          for (uint32_t l = 0; l < nTaps; l++)
+            {
+              double amplitude = std::sqrt (std::pow (10, powersDb[l] / 10) / totalPower);
+              expected += amplitude * taps[l]->GetComplexGain (at)
+                * std::polar (1.0, -2 * JakesPropagationLossModel::PI * f * delays[l]);
+            }
+          maxError = std::max (maxError, std::abs (response[k] - expected));
+        }
+      NS_TEST_EXPECT_MSG_LT (maxError, 1e-9, "The response differs from the sum of the taps at " << at);
+      NS_TEST_EXPECT_MSG_LT (std::abs (response[carrier] - process->GetComplexGain (at)), 1e-9,
+                             "The response at the carrier differs from the time domain gain at " << at);
+    }
+
+  // one delayed tap: the flat gain, rotated by the delay
+  Ptr<JakesProcess> flat = CreateProcess (std::vector<double> (1, 0), std::vector<double> (1, 0));
+  Ptr<JakesProcess> delayed = CreateProcess (std::vector<double> (1, 2e-6), std::vector<double> (1, -3));
+  for (uint32_t i = 0; i < sizeof (times) / sizeof (times[0]); i++)
+    {
+      Time at = Seconds (times[i]);
+      std::complex<double> gain = flat->GetComplexGain (at);
+      NS_TEST_EXPECT_MSG_LT (std::abs (delayed->GetComplexGain (at) - gain), 1e-12,
+                             "A single tap should give the flat gain at " << at);
+      flat->GetFrequencyResponse (at, nSubcarriers, spacing, response);
+      std::vector<std::complex<double> > delayedResponse;
+      delayed->GetFrequencyResponse (at, nSubcarriers, spacing, delayedResponse);
+      double maxError = 0;
+      for (uint32_t k = 0; k < nSubcarriers; k++)
+        {
+          maxError = std::max (maxError, std::abs (response[k] - gain));
+          maxError = std::max (maxError, std::abs (std::abs (delayedResponse[k]) - std::abs (gain)));
+        }
+      NS_TEST_EXPECT_MSG_LT (maxError, 1e-9, "A single tap should give a flat response at " << at);
+    }
+  Simulator::Destroy ();
+}
+
+// ===========================================================================
+// Statistical quality and throughput of a fading engine: long power series
+// of many links are compared with Rayleigh fading with the Clarke/Jakes
+// spectrum through
+//  - the Kolmogorov-Smirnov distance of the power gain to the exponential
+//    distribution of unit mean,
+//  - the autocorrelation of the power against J_0^2 (2 pi f_d tau),
+//  - the level crossing rate of the envelope at 0 and -10 dB, against
+//    N_R = sqrt (2 pi) f_d rho e^(-rho^2).
+// The statistics and the samples per second of the engine are logged, so
+// that an accelerated engine can be compared with the reference ones.
+// ===========================================================================
+class JakesStatisticsTestCase : public TestCase
+{
+public:
+  /// The engines producing the series
+  enum Engine
+  {
+    SumOfSinusoids, FilteredGaussian, Trace
+  };
+  JakesStatisticsTestCase (Engine engine);
+  virtual ~JakesStatisticsTestCase ();
+
+private:
+  virtual void DoRun (void);
+  static std::string GetEngineName (Engine engine);
+  /// Fill power with the power gain of nLinks links of nSamples samples
+  void Generate (std::vector<double> &power, uint32_t nLinks, uint32_t nSamples);
+
+  Engine m_engine;
+};
+
+static const double g_statisticsDopplerFrequencyHz = 80;
+static const double g_statisticsInterval = 0.0002;
+
+JakesStatisticsTestCase::JakesStatisticsTestCase (Engine engine)
+  : TestCase ("Check the statistics of the fading engine " + GetEngineName (engine)),
+    m_engine (engine)
+{
+}
+
+JakesStatisticsTestCase::~JakesStatisticsTestCase ()
+{
+}
+
+std::string
+JakesStatisticsTestCase::GetEngineName (Engine engine)
+{
+  switch (engine)
+    {
+    case SumOfSinusoids:
+      return "SumOfSinusoids";
+    case FilteredGaussian:
+      return "FilteredGaussian";
+    default:
+      return "Trace";
+    }
+}
+
+void
+JakesStatisticsTestCase::Generate (std::vector<double> &power, uint32_t nLinks, uint32_t nSamples)
+{
+  Ptr<JakesPropagationLossModel> jakes = CreateObject<JakesPropagationLossModel> ();
+  if (m_engine == FilteredGaussian)
+    {
+      // the Gaussian variates come from the second stream
+      jakes->SetAttribute ("FadingEngine", EnumValue (JakesPropagationLossModel::FilteredGaussian));
+    }
+  jakes->AssignStreams (1);
+  Time interval = Seconds (g_statisticsInterval);
+  power.resize (nLinks * nSamples);
+
+  Ptr<JakesFadingTrace> trace;
+  Ptr<UniformRandomVariable> offset;
+  if (m_engine == Trace)
+    {
+      // a single long trace, read by every link from a random offset; 100
+      // oscillators, since the links share one realization
+      const uint32_t nOscillators = 100;
+      Ptr<JakesProcess> process = CreateObject<JakesProcess> ();
+      process->SetAttribute ("NumberOfOscillators", UintegerValue (nOscillators));
+      process->SetAttribute ("DopplerFrequencyHz", DoubleValue (g_statisticsDopplerFrequencyHz));
+      process->SetPropagationLossModel (jakes);
+      std::string filename = CreateTempDirFilename ("jakes-statistics.trace");
+      JakesFadingTrace::Write (filename, process, interval, 65536, g_statisticsDopplerFrequencyHz, nOscillators);
+      process->Dispose ();
+      trace = Create<JakesFadingTrace> ();
+      trace->Open (filename);
+      offset = CreateObject<UniformRandomVariable> ();
+      offset->SetStream (3);
+    }
+
+  SystemWallClockMs timer;
+  timer.Start ();
+  for (uint32_t link = 0; link < nLinks; link++)
+    {
+      double *series = &power[link * nSamples];
+      if (m_engine == SumOfSinusoids)
+        {
+          Ptr<JakesProcess> process = CreateObject<JakesProcess> ();
+          process->SetAttribute ("DopplerFrequencyHz", DoubleValue (g_statisticsDopplerFrequencyHz));
+          process->SetPropagationLossModel (jakes);
+          for (uint32_t n = 0; n < nSamples; n++)
+            {
+              series[n] = std::norm (process->GetComplexGain (interval * n)) / 2;
+            }
+          process->Dispose ();
+        }
+      else if (m_engine == FilteredGaussian)
+        {
+          Ptr<FilteredGaussianFadingProcess> process = CreateObject<FilteredGaussianFadingProcess> ();
+          process->SetAttribute ("DopplerFrequencyHz", DoubleValue (g_statisticsDopplerFrequencyHz));
+          process->SetAttribute ("SampleInterval", TimeValue (interval));
+          process->SetAttribute ("NumberOfSamples", UintegerValue (16384));
+          process->SetPropagationLossModel (jakes);
+          for (uint32_t n = 0; n < nSamples; n++)
+            {
+              series[n] = std::norm (process->GetComplexGain (interval * n)) / 2;
+            }
+          process->Dispose ();
+        }
+      else
+        {
+          double start = offset->GetValue (0, trace->GetDuration ());
+          for (uint32_t n = 0; n < nSamples; n++)
+            {
+              series[n] = std::norm (trace->GetComplexGain (start + n * g_statisticsInterval)) / 2;
+            }
+        }
+    }
+  int64_t ms = timer.End ();
+  NS_LOG_INFO (GetEngineName (m_engine) << ": " << (ms > 0 ? power.size () * 1000.0 / ms : 0) << " samples/s");
+}
+
+void
+JakesStatisticsTestCase::DoRun (void)
+{
+  const uint32_t nLinks = 64;
+  const uint32_t nSamples = 5000;
+  const uint32_t maxLag = 200;
+  const uint32_t lagStep = 10;
+  std::vector<double> power;
+  Generate (power, nLinks, nSamples);
+
+  // autocorrelation of each link around its own mean, and up-crossings of
+  // the levels 0 and -10 dB of the unit mean power
+  const double levels[2] = { 1.0, 0.1 };
+  uint64_t crossings[2] = { 0, 0 };
+  std::vector<double> autocorrelation (maxLag / lagStep + 1, 0);
+  double meanPower = 0;
+  for (uint32_t link = 0; link < nLinks; link++)
+    {
+      const double *series = &power[link * nSamples];
+      double mean = 0;
+      for (uint32_t n = 0; n < nSamples; n++)
+        {
+          mean += series[n];
+        }
+      mean /= nSamples;
+      meanPower += mean / nLinks;
+      double variance = 0;
+      for (uint32_t n = 0; n < nSamples; n++)
+        {
+          variance += (series[n] - mean) * (series[n] - mean);
+        }
+      for (uint32_t i = 0; i < autocorrelation.size (); i++)
+        {
+          uint32_t lag = i * lagStep;
+          double covariance = 0;
+          for (uint32_t n = 0; n + lag < nSamples; n++)
+            {
+              covariance += (series[n] - mean) * (series[n + lag] - mean);
+            }
+          autocorrelation[i] += covariance / (nSamples - lag) / (variance / nSamples) / nLinks;
+        }
+      for (uint32_t n = 1; n < nSamples; n++)
+        {
+          for (uint32_t l = 0; l < 2; l++)
+            {
+              crossings[l] += (series[n - 1] < levels[l] && series[n] >= levels[l]);
+            }
+        }
+    }
+
+  double autocorrelationError = 0;
+  for (uint32_t i = 0; i < autocorrelation.size (); i++)
+    {
+      double j0 = BesselJ0 (2 * JakesPropagationLossModel::PI * g_statisticsDopplerFrequencyHz * i * lagStep * g_statisticsInterval);
+      autocorrelationError = std::max (autocorrelationError, std::fabs (autocorrelation[i] - j0 * j0));
+    }
+
+  double lcrError[2];
+  for (uint32_t l = 0; l < 2; l++)
+    {
+      double rate = crossings[l] / (nLinks * nSamples * g_statisticsInterval);
+      double expected = std::sqrt (2 * JakesPropagationLossModel::PI) * g_statisticsDopplerFrequencyHz
+        * std::sqrt (levels[l]) * std::exp (-levels[l]);
+      lcrError[l] = rate / expected - 1;
+    }
+
+  // Kolmogorov-Smirnov distance of the normalized power to 1 - e^-x
+  for (uint32_t i = 0; i < power.size (); i++)
+    {
+      power[i] /= meanPower;
+    }
+  std::sort (power.begin (), power.end ());
+  double ks = 0;
+  for (uint32_t i = 0; i < power.size (); i++)
+    {
+      double cdf = 1 - std::exp (-power[i]);
+      ks = std::max (ks, std::max (static_cast<double> (i + 1) / power.size () - cdf,
+                                   cdf - static_cast<double> (i) / power.size ()));
+    }
+
+  NS_LOG_INFO (GetEngineName (m_engine) << ": mean power " << meanPower << " KS distance " << ks
+                                        << " autocorrelation error " << autocorrelationError
+                                        << " LCR error " << lcrError[0] << " (0 dB) " << lcrError[1] << " (-10 dB)");
+  NS_TEST_EXPECT_MSG_EQ_TOL (meanPower, 1.0, 0.1, "Got unexpected mean power gain");
+  NS_TEST_EXPECT_MSG_LT (ks, 0.03, "The power gain is not exponentially distributed");
+  NS_TEST_EXPECT_MSG_LT (autocorrelationError, 0.1, "The autocorrelation departs from J0^2");
+  NS_TEST_EXPECT_MSG_EQ_TOL (lcrError[0], 0, 0.1, "Got unexpected level crossing rate at 0 dB");
+  NS_TEST_EXPECT_MSG_EQ_TOL (lcrError[1], 0, 0.1, "Got unexpected level crossing rate at -10 dB");
+  Simulator::Destroy ();
+}
+
+class JakesFadingTestSuite : public TestSuite
+{
+public:
+  JakesFadingTestSuite ();
+};
+
+JakesFadingTestSuite::JakesFadingTestSuite ()
+  : TestSuite ("jakes-fading", UNIT)
+{
+  AddTestCase (new FilteredGaussianAutocorrelationTestCase, TestCase::QUICK);
+  AddTestCase (new JakesChannelMatrixTestCase, TestCase::QUICK);
+  AddTestCase (new JakesFrequencyResponseTestCase, TestCase::QUICK);
+  AddTestCase (new JakesCoherenceReuseTestCase, TestCase::QUICK);
+  AddTestCase (new JakesTraceTestCase, TestCase::QUICK);
+  AddTestCase (new JakesStatisticsTestCase (JakesStatisticsTestCase::SumOfSinusoids), TestCase::QUICK);
+  AddTestCase (new JakesStatisticsTestCase (JakesStatisticsTestCase::FilteredGaussian), TestCase::QUICK);
+  AddTestCase (new JakesStatisticsTestCase (JakesStatisticsTestCase::Trace), TestCase::QUICK);
+}
+
+static JakesFadingTestSuite jakesFadingTestSuite;
@@ -0,0 +1,319 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/object-factory.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/recording-propagation-loss-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/simulator.h"
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("PropagationAllocationTest");
+
+/// Heap allocations counted since the last reset, while g_countAllocations is set
+static uint64_t g_allocations = 0;
+static bool g_countAllocations = false;
+
+// Counting replacements of the global allocation functions. They are
+// linked into the test library, so they replace operator new and delete
+// for every suite of the test runner, not only this one; outside of
+// StartCounting and StopCounting they only forward to malloc and free,
+// like the default operators of libstdc++ and libc++, so the other suites
+// allocate as before. None of them is inlined: g++ -O2 would otherwise
+// see free called on the result of operator new (-Wmismatched-new-delete).
+
+// dynamic exception specifications are an error from C++17 on
+#if __cplusplus >= 201103L
+#define ALLOCATION_THROW noexcept (false)
+#define ALLOCATION_NOTHROW noexcept
+#else
+#define ALLOCATION_THROW throw (std::bad_alloc)
+#define ALLOCATION_NOTHROW throw ()
+#endif
+
+/// \returns size bytes from malloc, 0 if there are none left
+static void *
+CountedMalloc (std::size_t size)
+{
+  if (g_countAllocations)
+    {
+      g_allocations++;
+    }
+  return std::malloc (size == 0 ? 1 : size);
+}
+
+void * __attribute__ ((noinline))
+operator new (std::size_t size) ALLOCATION_THROW
+{
+  void *p = CountedMalloc (size);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+void * __attribute__ ((noinline))
+operator new[] (std::size_t size) ALLOCATION_THROW
+{
+  void *p = CountedMalloc (size);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+void * __attribute__ ((noinline))
+operator new (std::size_t size, const std::nothrow_t &) ALLOCATION_NOTHROW
+{
+  return CountedMalloc (size);
+}
+
+void * __attribute__ ((noinline))
+operator new[] (std::size_t size, const std::nothrow_t &) ALLOCATION_NOTHROW
+{
+  return CountedMalloc (size);
+}
+
+void __attribute__ ((noinline))
+operator delete (void *p) ALLOCATION_NOTHROW
+{
+  std::free (p);
+}
+
+void __attribute__ ((noinline))
+operator delete[] (void *p) ALLOCATION_NOTHROW
+{
+  std::free (p);
+}
+
+#ifdef __cpp_sized_deallocation
+void __attribute__ ((noinline))
+operator delete (void *p, std::size_t) ALLOCATION_NOTHROW
+{
+  std::free (p);
+}
+
+void __attribute__ ((noinline))
+operator delete[] (void *p, std::size_t) ALLOCATION_NOTHROW
+{
+  std::free (p);
+}
+#endif
+
+void __attribute__ ((noinline))
+operator delete (void *p, const std::nothrow_t &) ALLOCATION_NOTHROW
+{
+  std::free (p);
+}
+
+void __attribute__ ((noinline))
+operator delete[] (void *p, const std::nothrow_t &) ALLOCATION_NOTHROW
+{
+  std::free (p);
+}
+
+static void
+StartCounting (void)
+{
+  g_allocations = 0;
+  g_countAllocations = true;
+}
+
+static uint64_t
+StopCounting (void)
+{
+  g_countAllocations = false;
+  return g_allocations;
+}
+
+/**
+ * Evaluates two warm links of a loss model, one near and one far,
+ * alternately many times and checks that no call allocates, unless
+ * warmLinkExemption is set. Unless newLinkExemption is set, also checks
+ * that the first call on new links does not allocate either.
+ */
+class PropagationAllocationTestCase : public TestCase
+{
+public:
+  /**
+   * \param typeId the type of the loss model
+   * \param newLinkExemption why the model may allocate on a new link, 0 if
+   * it may not
+   * \param warmLinkExemption why the model may allocate on a warm link, 0
+   * if it may not
+   */
+  PropagationAllocationTestCase (std::string typeId, const char *newLinkExemption,
+                                 const char *warmLinkExemption = 0);
+  virtual ~PropagationAllocationTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  std::string m_typeId;
+  const char *m_newLinkExemption;
+  const char *m_warmLinkExemption;
+};
+
+PropagationAllocationTestCase::PropagationAllocationTestCase (std::string typeId, const char *newLinkExemption,
+                                                              const char *warmLinkExemption)
+  : TestCase ("Check that " + typeId + " does not allocate on warm links"),
+    m_typeId (typeId),
+    m_newLinkExemption (newLinkExemption),
+    m_warmLinkExemption (warmLinkExemption)
+{
+}
+
+PropagationAllocationTestCase::~PropagationAllocationTestCase ()
+{
+}
+
+void
+PropagationAllocationTestCase::DoRun (void)
+{
+  const uint32_t nCalls = 1000;
+  ObjectFactory factory;
+  factory.SetTypeId (m_typeId);
+  Ptr<PropagationLossModel> model = factory.Create<PropagationLossModel> ();
+  // the recorder needs a trace to write to
+  Ptr<RecordingPropagationLossModel> recorder = DynamicCast<RecordingPropagationLossModel> (model);
+  if (recorder != 0)
+    {
+      recorder->SetFileName (CreateTempDirFilename ("allocation.trace"));
+    }
+  model->AssignStreams (1);
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 30));
+  // a far and a near link, on both sides of the distance fields of
+  // NakagamiPropagationLossModel (80 m and 200 m by default)
+  Ptr<MobilityModel> b[2];
+  b[0] = CreateObject<ConstantPositionMobilityModel> ();
+  b[0]->SetPosition (Vector (250, 20, 1.5));
+  b[1] = CreateObject<ConstantPositionMobilityModel> ();
+  b[1]->SetPosition (Vector (30, 10, 1.5));
+  std::vector<Ptr<MobilityModel> > receivers;
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      Ptr<MobilityModel> receiver = CreateObject<ConstantPositionMobilityModel> ();
+      if (i % 2)
+        {
+          receiver->SetPosition (Vector (10 + 0.5 * i, 10, 1.5));
+        }
+      else
+        {
+          receiver->SetPosition (Vector (100 + 10 * i, 50, 1.5));
+        }
+      receivers.push_back (receiver);
+    }
+
+  double sum = 0;
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      sum += model->CalcRxPower (20, a, b[i % 2]);
+    }
+  StartCounting ();
+  for (uint32_t i = 0; i < nCalls; ++i)
+    {
+      sum += model->CalcRxPower (20, a, b[i % 2]);
+    }
+  uint64_t allocations = StopCounting ();
+  if (m_warmLinkExemption == 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ (allocations, 0, m_typeId << " allocated on warm links");
+    }
+  else
+    {
+      NS_LOG_INFO (m_typeId << " made " << allocations << " allocations on warm links: " << m_warmLinkExemption);
+    }
+
+  if (m_newLinkExemption == 0)
+    {
+      StartCounting ();
+      for (uint32_t i = 0; i < receivers.size (); ++i)
+        {
+          sum += model->CalcRxPower (20, a, receivers[i]);
+        }
+      allocations = StopCounting ();
+      NS_TEST_EXPECT_MSG_EQ (allocations, 0, m_typeId << " allocated on new links");
+    }
+  else
+    {
+      NS_LOG_INFO (m_typeId << " may allocate on new links: " << m_newLinkExemption);
+    }
+  NS_LOG_DEBUG ("sum of the powers " << sum);
+  Simulator::Destroy ();
+}
+
+class PropagationAllocationTestSuite : public TestSuite
+{
+public:
+  PropagationAllocationTestSuite ();
+};
+
+PropagationAllocationTestSuite::PropagationAllocationTestSuite ()
+  : TestSuite ("propagation-allocation", UNIT)
+{
+  // models without per-link state must not allocate at all
+  const char *stateless[] = {
+    "ns3::RandomPropagationLossModel",
+    "ns3::FriisPropagationLossModel",
+    "ns3::TwoRayGroundPropagationLossModel",
+    "ns3::LogDistancePropagationLossModel",
+    "ns3::ThreeLogDistancePropagationLossModel",
+    "ns3::FixedRssLossModel",
+    "ns3::MatrixPropagationLossModel",
+    "ns3::RangePropagationLossModel",
+    "ns3::Cost231PropagationLossModel",
+    "ns3::Cost231WILossModel",
+    "ns3::OkumuraHataPropagationLossModel",
+    "ns3::ItuR1411LosPropagationLossModel",
+    "ns3::ItuR1411NlosOverRooftopPropagationLossModel",
+    "ns3::Kun2600MhzPropagationLossModel",
+    "ns3::ECC33PathLossModel",
+    "ns3::SUIPathLossModel",
+    "ns3::CorrelatedShadowingLossModel",
+  };
+  for (uint32_t i = 0; i < sizeof (stateless) / sizeof (stateless[0]); i++)
+    {
+      AddTestCase (new PropagationAllocationTestCase (stateless[i], 0), TestCase::QUICK);
+    }
+
+  // exemptions: models creating a state on the first call of a link
+  AddTestCase (new PropagationAllocationTestCase ("ns3::JakesPropagationLossModel",
+                                                  "creates a JakesProcess per link"),
+               TestCase::QUICK);
+  AddTestCase (new PropagationAllocationTestCase ("ns3::BlockFadingPropagationLossModel",
+                                                  "grows the arena of link gains"),
+               TestCase::QUICK);
+  AddTestCase (new PropagationAllocationTestCase ("ns3::RecordingPropagationLossModel",
+                                                  "numbers each new mobility model in a map and appends its position to the trace"),
+               TestCase::QUICK);
+
+  // exemptions: models whose state grows with the number of calls
+  const char *gammaRuns = "logs a run of Gamma draws per change of m for snapshots";
+  AddTestCase (new PropagationAllocationTestCase ("ns3::NakagamiPropagationLossModel", gammaRuns, gammaRuns),
+               TestCase::QUICK);
+}
+
+static PropagationAllocationTestSuite propagationAllocationTestSuite;
@@ -0,0 +1,287 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/object-factory.h"
+#include "ns3/propagation-environment.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/propagation-link-geometry.h"
+#include "ns3/propagation-link-state.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/simulator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("PropagationGoldenTest");
+
+/// One point of a golden file, see test/reference/write_golden.m and write_golden.py
+struct GoldenRecord
+{
+  double m_frequency;
+  double m_distance;
+  double m_hb;
+  double m_hm;
+  double m_loss;
+};
+
+/// Maximum and mean absolute error of a path against the golden losses
+class GoldenError
+{
+public:
+  GoldenError ()
+    : m_max (0),
+      m_sum (0),
+      m_n (0)
+  {
+  }
+  void Add (double loss, double golden)
+  {
+    double error = std::fabs (loss - golden);
+    m_max = std::max (m_max, error);
+    m_sum += error;
+    m_n++;
+  }
+  double GetMax (void) const
+  {
+    return m_max;
+  }
+  double GetMean (void) const
+  {
+    return m_n > 0 ? m_sum / m_n : 0;
+  }
+private:
+  double m_max;
+  double m_sum;
+  uint32_t m_n;
+};
+
+/**
+ * Checks a loss model against a golden file generated from the Octave
+ * references of test/reference, through the scalar CalcRxPower and through
+ * the accelerated paths: CalcRxPower with a shared link geometry and the
+ * batch PropagationLinkStateEvaluator. The max and mean errors of each path
+ * are logged.
+ */
+class PropagationGoldenTestCase : public TestCase
+{
+public:
+  /**
+   * \param file the golden file, in test/reference/golden
+   * \param factory the factory of the model, with the attributes matching
+   * the reference
+   * \param frequency whether the model has a Frequency attribute, set to the
+   * frequency of each record
+   */
+  PropagationGoldenTestCase (std::string file, ObjectFactory factory, bool frequency);
+  virtual ~PropagationGoldenTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void ReadRecords (std::vector<GoldenRecord> &records);
+
+  std::string m_file;
+  ObjectFactory m_factory;
+  bool m_frequency;
+};
+
+PropagationGoldenTestCase::PropagationGoldenTestCase (std::string file, ObjectFactory factory, bool frequency)
+  : TestCase ("Check a loss model against the golden vectors of " + file),
+    m_file (file),
+    m_factory (factory),
+    m_frequency (frequency)
+{
+}
+
+PropagationGoldenTestCase::~PropagationGoldenTestCase ()
+{
+}
+
+/**
+ * \param is the golden file
+ * \param size the number of bytes, at most 8
+ * \returns the next little endian integer of size bytes, whatever the
+ * byte order of the host
+ */
+static uint64_t
+ReadLittleEndian (std::istream &is, uint32_t size)
+{
+  unsigned char bytes[8];
+  is.read (reinterpret_cast<char *> (bytes), size);
+  NS_ABORT_MSG_UNLESS (is, "Truncated golden file");
+  uint64_t value = 0;
+  for (uint32_t i = size; i > 0; i--)
+    {
+      value = (value << 8) | bytes[i - 1];
+    }
+  return value;
+}
+
+/**
+ * \param is the golden file
+ * \returns the next little endian IEEE 754 double
+ */
+static double
+ReadLittleEndianDouble (std::istream &is)
+{
+  uint64_t bits = ReadLittleEndian (is, 8);
+  double value;
+  std::memcpy (&value, &bits, sizeof (value));
+  return value;
+}
+
+void
+PropagationGoldenTestCase::ReadRecords (std::vector<GoldenRecord> &records)
+{
+  std::ifstream is (CreateDataDirFilename ("reference/golden/" + m_file).c_str (), std::ios::binary);
+  NS_ABORT_MSG_UNLESS (is, "Could not open the golden file " << m_file);
+  records.resize (static_cast<uint32_t> (ReadLittleEndian (is, 4)));
+  for (uint32_t i = 0; i < records.size (); i++)
+    {
+      records[i].m_frequency = ReadLittleEndianDouble (is);
+      records[i].m_distance = ReadLittleEndianDouble (is);
+      records[i].m_hb = ReadLittleEndianDouble (is);
+      records[i].m_hm = ReadLittleEndianDouble (is);
+      records[i].m_loss = ReadLittleEndianDouble (is);
+    }
+}
+
+void
+PropagationGoldenTestCase::DoRun (void)
+{
+  // the references and the models compute the same formulas in double
+  const double tolerance = 1e-6;
+  std::vector<GoldenRecord> records;
+  ReadRecords (records);
+  NS_TEST_ASSERT_MSG_GT (records.size (), 0, "Empty golden file " << m_file);
+
+  Ptr<PropagationLossModel> model = m_factory.Create<PropagationLossModel> ();
+  Ptr<PropagationLinkStateEvaluator> evaluator = CreateObject<PropagationLinkStateEvaluator> ();
+  evaluator->SetLossModel (model);
+  evaluator->SetDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+
+  GoldenError scalar;
+  GoldenError geometry;
+  GoldenError batch;
+  std::vector<PropagationLinkState> states;
+  uint32_t begin = 0;
+  while (begin < records.size ())
+    {
+      // a run of records with the same frequency and base station, i.e.
+      // the receivers of one transmission
+      uint32_t end = begin;
+      while (end < records.size ()
+             && records[end].m_frequency == records[begin].m_frequency
+             && records[end].m_hb == records[begin].m_hb)
+        {
+          end++;
+        }
+      if (m_frequency)
+        {
+          model->SetAttribute ("Frequency", DoubleValue (records[begin].m_frequency));
+        }
+      Ptr<MobilityModel> tx = CreateObject<ConstantPositionMobilityModel> ();
+      tx->SetPosition (Vector (0.0, 0.0, records[begin].m_hb));
+      std::vector<Ptr<MobilityModel> > rx;
+      for (uint32_t i = begin; i < end; i++)
+        {
+          // the distance of the references is the distance in 3D
+          double dz = records[i].m_hb - records[i].m_hm;
+          NS_ASSERT (records[i].m_distance > std::fabs (dz));
+          Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+          mobility->SetPosition (Vector (std::sqrt (records[i].m_distance * records[i].m_distance - dz * dz),
+                                         0.0, records[i].m_hm));
+          rx.push_back (mobility);
+        }
+      evaluator->Evaluate (0, tx, rx, states);
+      for (uint32_t i = begin; i < end; i++)
+        {
+          Ptr<MobilityModel> mobility = rx[i - begin];
+          scalar.Add (-model->CalcRxPower (0, tx, mobility), records[i].m_loss);
+          geometry.Add (-model->CalcRxPower (0, PropagationLinkGeometry (tx, mobility)), records[i].m_loss);
+          batch.Add (-states[i - begin].m_rxPowerDbm, records[i].m_loss);
+        }
+      begin = end;
+    }
+
+  NS_LOG_INFO (m_file << ": " << records.size () << " points,"
+                      << " scalar max " << scalar.GetMax () << " mean " << scalar.GetMean () << " dB,"
+                      << " geometry max " << geometry.GetMax () << " mean " << geometry.GetMean () << " dB,"
+                      << " batch max " << batch.GetMax () << " mean " << batch.GetMean () << " dB");
+  NS_TEST_EXPECT_MSG_LT (scalar.GetMax (), tolerance, "Scalar path off the golden vectors of " << m_file);
+  NS_TEST_EXPECT_MSG_LT (geometry.GetMax (), tolerance, "Geometry path off the golden vectors of " << m_file);
+  NS_TEST_EXPECT_MSG_LT (batch.GetMax (), tolerance, "Batch path off the golden vectors of " << m_file);
+  Simulator::Destroy ();
+}
+
+class PropagationGoldenTestSuite : public TestSuite
+{
+public:
+  PropagationGoldenTestSuite ();
+private:
+  void AddOkumuraHata (std::string file, EnvironmentType environment, CitySize citySize);
+};
+
+PropagationGoldenTestSuite::PropagationGoldenTestSuite ()
+  : TestSuite ("propagation-golden", SYSTEM)
+{
+  LogComponentEnable ("PropagationGoldenTest", LOG_LEVEL_INFO);
+  SetDataDir (NS_TEST_SOURCEDIR);
+
+  // the suburban and open areas references use the height correction of
+  // small cities
+  AddOkumuraHata ("oh-large-cities-urban.bin", UrbanEnvironment, LargeCity);
+  AddOkumuraHata ("oh-small-cities-urban.bin", UrbanEnvironment, SmallCity);
+  AddOkumuraHata ("oh-suburban.bin", SubUrbanEnvironment, SmallCity);
+  AddOkumuraHata ("oh-openareas.bin", OpenAreasEnvironment, SmallCity);
+  AddOkumuraHata ("cost231-large-cities-urban.bin", UrbanEnvironment, LargeCity);
+  AddOkumuraHata ("cost231-small-cities-urban.bin", UrbanEnvironment, SmallCity);
+
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::ItuR1411LosPropagationLossModel");
+  AddTestCase (new PropagationGoldenTestCase ("itu1411-los.bin", factory, true), TestCase::QUICK);
+
+  // the reference was written with big = 0, the kf of the model in large
+  // urban cities
+  factory.SetTypeId ("ns3::ItuR1411NlosOverRooftopPropagationLossModel");
+  factory.Set ("Environment", EnumValue (UrbanEnvironment));
+  factory.Set ("CitySize", EnumValue (LargeCity));
+  AddTestCase (new PropagationGoldenTestCase ("itu1411-nlos-over-rooftop.bin", factory, true), TestCase::QUICK);
+
+  factory = ObjectFactory ();
+  factory.SetTypeId ("ns3::Kun2600MhzPropagationLossModel");
+  AddTestCase (new PropagationGoldenTestCase ("kun-2600-mhz.bin", factory, false), TestCase::QUICK);
+}
+
+void
+PropagationGoldenTestSuite::AddOkumuraHata (std::string file, EnvironmentType environment, CitySize citySize)
+{
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::OkumuraHataPropagationLossModel");
+  factory.Set ("Environment", EnumValue (environment));
+  factory.Set ("CitySize", EnumValue (citySize));
+  AddTestCase (new PropagationGoldenTestCase (file, factory, true), TestCase::QUICK);
+}
+
+static PropagationGoldenTestSuite propagationGoldenTestSuite;
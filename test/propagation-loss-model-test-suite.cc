@@ -22,13 +22,36 @@
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/block-fading-propagation-loss-model.h"
+#include "ns3/jakes-propagation-loss-model.h"
+#include "ns3/sui-loss-model.h"
+#include "ns3/correlated-shadowing-loss-model.h"
+#include "ns3/counter-based-rng.h"
+#include "ns3/propagation-link-state.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/recording-propagation-loss-model.h"
+#include "ns3/boolean.h"
+#include "ns3/node-container.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
+#include <sstream>
+#include <algorithm>
+#include <limits>
 
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("PropagationLossModelsTest");
 
+/// \returns a LogDistance and Nakagami chain with its streams assigned
+static Ptr<PropagationLossModel>
+CreateChain (void)
+{
+  Ptr<LogDistancePropagationLossModel> pathLoss = CreateObject<LogDistancePropagationLossModel> ();
+  pathLoss->SetNext (CreateObject<NakagamiPropagationLossModel> ());
+  pathLoss->AssignStreams (1);
+  return pathLoss;
+}
+
 // ===========================================================================
 // This is a simple test to validate propagation loss models of ns-3 wifi.
 // See the chapter in the ns-3 testing and validation guide for more detail
@@ -436,6 +459,1000 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class BlockFadingPropagationLossModelTestCase : public TestCase
+{
+public:
+  BlockFadingPropagationLossModelTestCase ();
+  virtual ~BlockFadingPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BlockFadingPropagationLossModelTestCase::BlockFadingPropagationLossModelTestCase ()
+  : TestCase ("Test BlockFadingPropagationLossModel")
+{
+}
+
+BlockFadingPropagationLossModelTestCase::~BlockFadingPropagationLossModelTestCase ()
+{
+}
+
+void
+BlockFadingPropagationLossModelTestCase::DoRun (void)
+{
+  const uint32_t nLinks = 4000;
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  std::vector<Ptr<MobilityModel> > b;
+  for (uint32_t i = 0; i < nLinks; ++i)
+    {
+      b.push_back (CreateObject<ConstantPositionMobilityModel> ());
+    }
+
+  Ptr<BlockFadingPropagationLossModel> lossModel = CreateObject<BlockFadingPropagationLossModel> ();
+  lossModel->SetAttribute ("BlockDuration", TimeValue (MilliSeconds (10)));
+  lossModel->AssignStreams (1);
+
+  // the gain is constant within a block and has unit mean over the links
+  std::vector<double> first;
+  double meanGain = 0;
+  for (uint32_t i = 0; i < nLinks; ++i)
+    {
+      first.push_back (lossModel->CalcRxPower (0, a, b[i]));
+      meanGain += std::pow (10.0, first[i] / 10.0) / nLinks;
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (meanGain, 1.0, 0.1, "Block gains should have unit mean");
+  Simulator::Stop (MilliSeconds (5));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (lossModel->CalcRxPower (0, a, b[0]), first[0], "Gain changed within a block");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->CalcRxPower (0, b[1], a), first[1], "Gain should be symmetric");
+
+  // a new block has a new gain
+  Simulator::Stop (MilliSeconds (10));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_NE (lossModel->CalcRxPower (0, a, b[0]), first[0], "Gain should change with the block");
+  Simulator::Destroy ();
+}
+
+class SUIPathLossModelTestCase : public TestCase
+{
+public:
+  SUIPathLossModelTestCase ();
+  virtual ~SUIPathLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SUIPathLossModelTestCase::SUIPathLossModelTestCase ()
+  : TestCase ("Test the streams and frozen shadowing of SUIPathLossModel")
+{
+}
+
+SUIPathLossModelTestCase::~SUIPathLossModelTestCase ()
+{
+}
+
+void
+SUIPathLossModelTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (1000, 0, 0));
+
+  // models on the same streams give the same losses
+  Ptr<SUIPathLossModel> first = CreateObject<SUIPathLossModel> ();
+  Ptr<SUIPathLossModel> second = CreateObject<SUIPathLossModel> ();
+  NS_TEST_ASSERT_MSG_EQ (first->AssignStreams (1), 3, "SUIPathLossModel should use three streams");
+  second->AssignStreams (1);
+  double loss = first->CalcRxPower (0, a, b);
+  NS_TEST_EXPECT_MSG_EQ (second->CalcRxPower (0, a, b), loss, "Same streams should give the same loss");
+  NS_TEST_EXPECT_MSG_NE (first->CalcRxPower (0, a, b), loss, "Shadowing should be drawn on every call");
+
+  // frozen shadowing is drawn once per link
+  Ptr<SUIPathLossModel> frozen = CreateObject<SUIPathLossModel> ();
+  frozen->SetAttribute ("FreezeShadowing", BooleanValue (true));
+  frozen->AssignStreams (1);
+  NS_TEST_EXPECT_MSG_EQ (frozen->CalcRxPower (0, a, b), loss, "The first draw should not depend on FreezeShadowing");
+  NS_TEST_EXPECT_MSG_EQ (frozen->CalcRxPower (0, b, a), loss, "Frozen shadowing should be reused");
+  Simulator::Destroy ();
+}
+
+class CorrelatedShadowingLossModelTestCase : public TestCase
+{
+public:
+  CorrelatedShadowingLossModelTestCase ();
+  virtual ~CorrelatedShadowingLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CorrelatedShadowingLossModelTestCase::CorrelatedShadowingLossModelTestCase ()
+  : TestCase ("Test the statistics of the CorrelatedShadowingLossModel map")
+{
+}
+
+CorrelatedShadowingLossModelTestCase::~CorrelatedShadowingLossModelTestCase ()
+{
+}
+
+void
+CorrelatedShadowingLossModelTestCase::DoRun (void)
+{
+  const double size = 2000;
+  const double resolution = 10;
+  const double sigma = 8;
+  Ptr<CorrelatedShadowingLossModel> lossModel = CreateObject<CorrelatedShadowingLossModel> ();
+  lossModel->SetAttribute ("Bounds", RectangleValue (Rectangle (0, size, 0, size)));
+  lossModel->SetAttribute ("Resolution", DoubleValue (resolution));
+  lossModel->SetAttribute ("DecorrelationDistance", DoubleValue (50));
+  lossModel->SetAttribute ("Sigma", DoubleValue (sigma));
+  lossModel->AssignStreams (1);
+
+  // the map has the requested deviation, and its correlation at the
+  // decorrelation distance (5 points) is 1/e
+  const uint32_t n = static_cast<uint32_t> (size / resolution) + 1;
+  const uint32_t lag = 5;
+  std::vector<double> field (n * n);
+  double mean = 0;
+  for (uint32_t j = 0; j < n; ++j)
+    {
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          field[j * n + i] = lossModel->GetShadowing (Vector (i * resolution, j * resolution, 0));
+          mean += field[j * n + i] / (n * n);
+        }
+    }
+  double variance = 0;
+  double covariance = 0;
+  for (uint32_t j = 0; j < n; ++j)
+    {
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          variance += std::pow (field[j * n + i] - mean, 2) / (n * n);
+          if (i + lag < n)
+            {
+              covariance += (field[j * n + i] - mean) * (field[j * n + i + lag] - mean) / (n * (n - lag));
+            }
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (mean, 0, 2, "Shadowing should have zero mean");
+  NS_TEST_EXPECT_MSG_EQ_TOL (std::sqrt (variance), sigma, 1, "Got unexpected shadowing deviation");
+  NS_TEST_EXPECT_MSG_EQ_TOL (covariance / variance, std::exp (-1.0), 0.1, "Got unexpected shadowing correlation");
+
+  // the loss combines both ends, and does not change between calls
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (105, 333, 0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (1500, 20, 0));
+  double expected = -(lossModel->GetShadowing (a->GetPosition ()) + lossModel->GetShadowing (b->GetPosition ())) / std::sqrt (2.0);
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (0, a, b), expected, 1e-9, "Got unexpected shadowing loss");
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (0, b, a), expected, 1e-9, "Shadowing loss should be symmetric");
+  Simulator::Destroy ();
+}
+
+class PowerDomainTestCase : public TestCase
+{
+public:
+  PowerDomainTestCase ();
+  virtual ~PowerDomainTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PowerDomainTestCase::PowerDomainTestCase ()
+  : TestCase ("Test that chains give the same power in dBm and in Watt")
+{
+}
+
+PowerDomainTestCase::~PowerDomainTestCase ()
+{
+}
+
+void
+PowerDomainTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (30, 0, 0));
+
+  NS_TEST_EXPECT_MSG_EQ_TOL (PropagationLossModel::DbmToW (30), 1.0, 1e-15, "1 W is 30 dBm");
+  NS_TEST_EXPECT_MSG_EQ_TOL (PropagationLossModel::WToDbm (1e-3), 0.0, 1e-12, "1 mW is 0 dBm");
+
+  // a Watt model (Nakagami) between dBm models
+  Ptr<PropagationLossModel> dbm = CreateChain ();
+  dbm->GetNext ()->SetNext (CreateObject<BlockFadingPropagationLossModel> ());
+  dbm->AssignStreams (1);
+  Ptr<PropagationLossModel> watt = CreateChain ();
+  watt->GetNext ()->SetNext (CreateObject<BlockFadingPropagationLossModel> ());
+  watt->AssignStreams (1);
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      double expected = PropagationLossModel::DbmToW (dbm->CalcRxPower (20, a, b));
+      double rxPowerW = watt->CalcRxPowerW (PropagationLossModel::DbmToW (20), a, b);
+      NS_TEST_EXPECT_MSG_EQ_TOL (rxPowerW / expected, 1.0, 1e-12, "Got unexpected power in Watt");
+    }
+  Simulator::Destroy ();
+}
+
+class NakagamiInverseCdfTestCase : public TestCase
+{
+public:
+  NakagamiInverseCdfTestCase ();
+  virtual ~NakagamiInverseCdfTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NakagamiInverseCdfTestCase::NakagamiInverseCdfTestCase ()
+  : TestCase ("Test the inverse CDF table sampling of NakagamiPropagationLossModel")
+{
+}
+
+NakagamiInverseCdfTestCase::~NakagamiInverseCdfTestCase ()
+{
+}
+
+void
+NakagamiInverseCdfTestCase::DoRun (void)
+{
+  const uint32_t nSamples = 50000;
+  const double mValues[] = { 0.75, 1.0, 3.0 };
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (10, 0, 0));
+
+  for (uint32_t k = 0; k < 3; ++k)
+    {
+      Ptr<NakagamiPropagationLossModel> sampled = CreateObject<NakagamiPropagationLossModel> ();
+      sampled->SetAttribute ("m0", DoubleValue (mValues[k]));
+      NS_TEST_ASSERT_MSG_EQ (sampled->AssignStreams (1), 2, "NakagamiPropagationLossModel should keep two streams without the table");
+      Ptr<NakagamiPropagationLossModel> tabulated = CreateObject<NakagamiPropagationLossModel> ();
+      tabulated->SetAttribute ("m0", DoubleValue (mValues[k]));
+      tabulated->SetAttribute ("UseInverseCdfTable", BooleanValue (true));
+      NS_TEST_ASSERT_MSG_EQ (tabulated->AssignStreams (4), 3, "NakagamiPropagationLossModel should use three streams with the table");
+
+      std::vector<double> x;
+      std::vector<double> y;
+      for (uint32_t i = 0; i < nSamples; ++i)
+        {
+          x.push_back (sampled->CalcRxPower (0, a, b));
+          y.push_back (tabulated->CalcRxPower (0, a, b));
+        }
+
+      // two sample Kolmogorov-Smirnov statistic
+      std::sort (x.begin (), x.end ());
+      std::sort (y.begin (), y.end ());
+      double maxDistance = 0;
+      uint32_t i = 0;
+      uint32_t j = 0;
+      while (i < nSamples && j < nSamples)
+        {
+          double value = std::min (x[i], y[j]);
+          while (i < nSamples && x[i] == value)
+            {
+              ++i;
+            }
+          while (j < nSamples && y[j] == value)
+            {
+              ++j;
+            }
+          maxDistance = std::max (maxDistance, std::fabs (static_cast<double> (i) - j) / nSamples);
+        }
+      NS_TEST_EXPECT_MSG_LT (maxDistance, 0.015, "Tabulated gains do not follow the Nakagami distribution for m=" << mValues[k]);
+    }
+  Simulator::Destroy ();
+}
+
+class CounterBasedStreamsTestCase : public TestCase
+{
+public:
+  CounterBasedStreamsTestCase ();
+  virtual ~CounterBasedStreamsTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /// \returns the losses of every link of the chain, the links being evaluated in the given order
+  std::vector<double> Evaluate (Ptr<PropagationLossModel> model, bool reverse);
+
+  std::vector<Ptr<MobilityModel> > m_mobility;
+};
+
+CounterBasedStreamsTestCase::CounterBasedStreamsTestCase ()
+  : TestCase ("Test that counter-based streams do not depend on the evaluation order")
+{
+}
+
+CounterBasedStreamsTestCase::~CounterBasedStreamsTestCase ()
+{
+}
+
+std::vector<double>
+CounterBasedStreamsTestCase::Evaluate (Ptr<PropagationLossModel> model, bool reverse)
+{
+  const uint32_t n = m_mobility.size ();
+  const uint32_t nLinks = n * (n - 1) / 2;
+  std::vector<double> losses (3 * nLinks);
+  for (uint32_t round = 0; round < 3; ++round)
+    {
+      for (uint32_t k = 0; k < nLinks; ++k)
+        {
+          uint32_t link = reverse ? nLinks - 1 - k : k;
+          // link index to node pair
+          uint32_t i = 0;
+          uint32_t first = link;
+          while (first >= n - 1 - i)
+            {
+              first -= n - 1 - i;
+              ++i;
+            }
+          uint32_t j = i + 1 + first;
+          losses[round * nLinks + link] = model->CalcRxPower (0, m_mobility[i], m_mobility[j]);
+        }
+    }
+  return losses;
+}
+
+void
+CounterBasedStreamsTestCase::DoRun (void)
+{
+  // known answer of Random123
+  uint32_t counter[4] = { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 };
+  uint32_t key[2] = { 0xa4093822, 0x299f31d0 };
+  uint32_t result[4];
+  CounterBasedRng::Philox4x32 (counter, key, result);
+  NS_TEST_EXPECT_MSG_EQ (result[0], 0xd16cfe09, "Got unexpected Philox4x32-10 output");
+  NS_TEST_EXPECT_MSG_EQ (result[3], 0x24126ea1, "Got unexpected Philox4x32-10 output");
+
+  // the bulk normals continue the sequence of GetNormal
+  CounterBasedRng single;
+  CounterBasedRng bulk;
+  single.SetStream (3);
+  bulk.SetStream (3);
+  single.Seek (5, 0);
+  bulk.Seek (5, 0);
+  double normals[8];
+  normals[0] = bulk.GetNormal ();
+  bulk.GetNormals (normals + 1, 4);
+  bulk.GetNormals (normals + 5, 3);
+  for (uint32_t i = 0; i < 8; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (normals[i], single.GetNormal (), "Bulk normal " << i << " differs from GetNormal");
+    }
+
+  NodeContainer nodes;
+  nodes.Create (4);
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      Ptr<MobilityModel> m = CreateObject<ConstantPositionMobilityModel> ();
+      m->SetPosition (Vector (i * 50.0, 0, 0));
+      nodes.Get (i)->AggregateObject (m);
+      m_mobility.push_back (m);
+    }
+
+  for (uint32_t type = 0; type < 3; ++type)
+    {
+      std::vector<double> losses[2];
+      for (uint32_t reverse = 0; reverse < 2; ++reverse)
+        {
+          Ptr<PropagationLossModel> model;
+          if (type == 0)
+            {
+              model = CreateObject<NakagamiPropagationLossModel> ();
+              model->SetAttribute ("m1", DoubleValue (1.5));
+            }
+          else if (type == 1)
+            {
+              model = CreateObject<SUIPathLossModel> ();
+              model->SetAttribute ("MinDistance", DoubleValue (10));
+            }
+          else
+            {
+              model = CreateObject<JakesPropagationLossModel> ();
+            }
+          model->SetAttribute ("CounterBasedStreams", BooleanValue (true));
+          model->AssignStreams (7);
+          losses[reverse] = Evaluate (model, reverse == 1);
+        }
+      for (uint32_t k = 0; k < losses[0].size (); ++k)
+        {
+          NS_TEST_EXPECT_MSG_EQ (losses[1][k], losses[0][k],
+                                 "Loss " << k << " of model " << type << " depends on the evaluation order");
+        }
+      NS_TEST_EXPECT_MSG_NE (losses[0][0], losses[0][1], "Links should get different sequences");
+    }
+  Simulator::Destroy ();
+}
+
+class PropagationCutoffTestCase : public TestCase
+{
+public:
+  PropagationCutoffTestCase ();
+  virtual ~PropagationCutoffTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PropagationCutoffTestCase::PropagationCutoffTestCase ()
+  : TestCase ("Test that chains skip the bounded models below the cutoff")
+{
+}
+
+PropagationCutoffTestCase::~PropagationCutoffTestCase ()
+{
+}
+
+void
+PropagationCutoffTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+  Ptr<MobilityModel> near = CreateObject<ConstantPositionMobilityModel> ();
+  near->SetPosition (Vector (10, 0, 0));
+  Ptr<MobilityModel> far = CreateObject<ConstantPositionMobilityModel> ();
+  far->SetPosition (Vector (5000, 0, 0));
+
+  Ptr<NakagamiPropagationLossModel> nakagami = CreateObject<NakagamiPropagationLossModel> ();
+  double maxGainDb = nakagami->GetMaxGainDb ();
+  NS_TEST_EXPECT_MSG_GT (maxGainDb, 0, "The 0.9999 quantile of the gain should be positive");
+  NS_TEST_EXPECT_MSG_LT (maxGainDb, 20, "The 0.9999 quantile of the gain is too large");
+  nakagami->SetAttribute ("MaxGainQuantile", DoubleValue (1));
+  NS_TEST_EXPECT_MSG_EQ (nakagami->GetMaxGainDb (), std::numeric_limits<double>::infinity (),
+                         "A quantile of 1 should not bound the gain");
+
+  Ptr<PropagationLossModel> chain = CreateChain ();
+  Ptr<PropagationLossModel> reference = CreateChain ();
+  // the far link is skipped without drawing from the Nakagami model
+  NS_TEST_EXPECT_MSG_EQ (chain->CalcRxPower (20, a, far, -100), -std::numeric_limits<double>::infinity (),
+                         "The far link should be below the cutoff");
+  NS_TEST_EXPECT_MSG_EQ (chain->CalcRxPowerW (0.1, a, far, 1e-13), 0,
+                         "The far link should be below the cutoff");
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (chain->CalcRxPower (20, a, near, -100), reference->CalcRxPower (20, a, near),
+                             "The near link should not be affected by the cutoff");
+    }
+  Simulator::Destroy ();
+}
+
+class ConstantSpeedDelayTestCase : public TestCase
+{
+public:
+  ConstantSpeedDelayTestCase ();
+  virtual ~ConstantSpeedDelayTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ConstantSpeedDelayTestCase::ConstantSpeedDelayTestCase ()
+  : TestCase ("Test that the delay in time steps rounds like Seconds")
+{
+}
+
+ConstantSpeedDelayTestCase::~ConstantSpeedDelayTestCase ()
+{
+}
+
+void
+ConstantSpeedDelayTestCase::DoRun (void)
+{
+  const double speeds[] = { 300000000.0, 299792458.0, 2e9, 1500.0, 343.0 };
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  uniform->SetStream (1);
+
+  for (uint32_t k = 0; k < 5; ++k)
+    {
+      Ptr<ConstantSpeedPropagationDelayModel> delay = CreateObject<ConstantSpeedPropagationDelayModel> ();
+      delay->SetAttribute ("Speed", DoubleValue (speeds[k]));
+      std::vector<Ptr<MobilityModel> > rx;
+      for (uint32_t i = 0; i < 1000; ++i)
+        {
+          // integer distances hit step boundaries for most speeds
+          double distance = (i % 2 == 0) ? i / 2 : uniform->GetValue (0, 10000);
+          Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+          b->SetPosition (Vector (distance, 0, 0));
+          rx.push_back (b);
+          NS_TEST_EXPECT_MSG_EQ (delay->GetDelay (a, b), Seconds (distance / speeds[k]),
+                                 "Got unexpected delay at " << distance << "m and " << speeds[k] << "m/s");
+        }
+      std::vector<int64_t> ticks;
+      delay->GetDelayTicks (a, rx, ticks);
+      NS_TEST_ASSERT_MSG_EQ (ticks.size (), rx.size (), "There should be one delay per receiver");
+      for (uint32_t i = 0; i < rx.size (); ++i)
+        {
+          NS_TEST_EXPECT_MSG_EQ (ticks[i], delay->GetDelay (a, rx[i]).GetTimeStep (),
+                                 "The batch delay differs from GetDelay");
+        }
+    }
+}
+
+class PropagationLinkStateTestCase : public TestCase
+{
+public:
+  PropagationLinkStateTestCase ();
+  virtual ~PropagationLinkStateTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PropagationLinkStateTestCase::PropagationLinkStateTestCase ()
+  : TestCase ("Test that the link state evaluator matches the delay and loss models")
+{
+}
+
+PropagationLinkStateTestCase::~PropagationLinkStateTestCase ()
+{
+}
+
+void
+PropagationLinkStateTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> tx = CreateObject<ConstantPositionMobilityModel> ();
+  tx->SetPosition (Vector (0, 0, 0));
+  std::vector<Ptr<MobilityModel> > rx;
+  for (uint32_t i = 0; i < 20; ++i)
+    {
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (7.5 * (i + 1), 3.0 * i, 1.5));
+      rx.push_back (mobility);
+    }
+
+  Ptr<ConstantSpeedPropagationDelayModel> delay = CreateObject<ConstantSpeedPropagationDelayModel> ();
+  Ptr<PropagationLossModel> reference = CreateChain ();
+  Ptr<PropagationLinkStateEvaluator> evaluator = CreateObject<PropagationLinkStateEvaluator> ();
+  evaluator->SetLossModel (CreateChain ());
+  evaluator->SetDelayModel (delay);
+
+  std::vector<PropagationLinkState> states;
+  for (uint32_t round = 0; round < 3; ++round)
+    {
+      evaluator->Evaluate (20, tx, rx, states);
+      NS_TEST_ASSERT_MSG_EQ (states.size (), rx.size (), "There should be one state per receiver");
+      for (uint32_t i = 0; i < rx.size (); ++i)
+        {
+          NS_TEST_EXPECT_MSG_EQ (states[i].m_delayTicks, delay->GetDelay (tx, rx[i]).GetTimeStep (),
+                                 "Got unexpected delay for receiver " << i);
+          NS_TEST_EXPECT_MSG_EQ (states[i].m_rxPowerDbm, reference->CalcRxPower (20, tx, rx[i]),
+                                 "Got unexpected power for receiver " << i);
+        }
+    }
+  PropagationLinkState state = evaluator->Evaluate (20, tx, rx[0]);
+  NS_TEST_EXPECT_MSG_EQ (state.m_delayTicks, delay->GetDelay (tx, rx[0]).GetTimeStep (), "Got unexpected delay");
+  NS_TEST_EXPECT_MSG_EQ (state.m_rxPowerDbm, reference->CalcRxPower (20, tx, rx[0]), "Got unexpected power");
+  Simulator::Destroy ();
+}
+
+class PropagationTimingTestCase : public TestCase
+{
+public:
+  PropagationTimingTestCase ();
+  virtual ~PropagationTimingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void StageTime (uint32_t stage, Ptr<const PropagationLossModel> model, int64_t ns);
+  void CalcTime (int64_t ns);
+
+  uint32_t m_stageCalls[2];
+  uint32_t m_calcCalls;
+};
+
+PropagationTimingTestCase::PropagationTimingTestCase ()
+  : TestCase ("Test the timing of the stages of a chain")
+{
+}
+
+PropagationTimingTestCase::~PropagationTimingTestCase ()
+{
+}
+
+void
+PropagationTimingTestCase::StageTime (uint32_t stage, Ptr<const PropagationLossModel> model, int64_t ns)
+{
+  NS_TEST_ASSERT_MSG_LT (stage, 2, "The chain has two stages");
+  NS_TEST_EXPECT_MSG_GT (ns, -1, "A stage cannot take a negative time");
+  m_stageCalls[stage]++;
+}
+
+void
+PropagationTimingTestCase::CalcTime (int64_t ns)
+{
+  m_calcCalls++;
+}
+
+void
+PropagationTimingTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (50, 0, 0));
+
+  Ptr<LogDistancePropagationLossModel> pathLoss = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<NakagamiPropagationLossModel> nakagami = CreateObject<NakagamiPropagationLossModel> ();
+  pathLoss->SetNext (nakagami);
+  pathLoss->AssignStreams (1);
+  pathLoss->TraceConnectWithoutContext ("StageTime", MakeCallback (&PropagationTimingTestCase::StageTime, this));
+  pathLoss->TraceConnectWithoutContext ("CalcTime", MakeCallback (&PropagationTimingTestCase::CalcTime, this));
+  m_stageCalls[0] = 0;
+  m_stageCalls[1] = 0;
+  m_calcCalls = 0;
+
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      pathLoss->CalcRxPower (20, a, b);
+    }
+  NS_TEST_EXPECT_MSG_EQ (pathLoss->GetTimedCalls (), 0, "Timing is off by default");
+  NS_TEST_EXPECT_MSG_EQ (m_calcCalls, 0, "Timing is off by default");
+
+  pathLoss->SetAttribute ("EnableTiming", BooleanValue (true));
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      pathLoss->CalcRxPower (20, a, b);
+    }
+  pathLoss->SetAttribute ("EnableTiming", BooleanValue (false));
+  pathLoss->CalcRxPower (20, a, b);
+
+  NS_TEST_EXPECT_MSG_EQ (m_calcCalls, 100, "CalcTime should fire once per timed call");
+  NS_TEST_EXPECT_MSG_EQ (m_stageCalls[0], 100, "StageTime should fire once per stage");
+  NS_TEST_EXPECT_MSG_EQ (m_stageCalls[1], 100, "StageTime should fire once per stage");
+  Ptr<PropagationLossModel> stages[2] = { pathLoss, nakagami };
+  for (uint32_t k = 0; k < 2; ++k)
+    {
+      NS_TEST_EXPECT_MSG_EQ (stages[k]->GetTimedCalls (), 100, "Got unexpected number of timed calls");
+      std::vector<uint64_t> histogram = stages[k]->GetTimeHistogram ();
+      uint64_t total = 0;
+      for (uint32_t i = 0; i < histogram.size (); ++i)
+        {
+          total += histogram[i];
+        }
+      NS_TEST_EXPECT_MSG_EQ (total, 100, "The histogram should count every timed call");
+      stages[k]->ResetTiming ();
+      NS_TEST_EXPECT_MSG_EQ (stages[k]->GetTimedNs (), 0, "ResetTiming should clear the total time");
+    }
+  Simulator::Destroy ();
+}
+
+class PropagationSnapshotTestCase : public TestCase
+{
+public:
+  PropagationSnapshotTestCase ();
+  virtual ~PropagationSnapshotTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PropagationSnapshotTestCase::PropagationSnapshotTestCase ()
+  : TestCase ("Test that a restored snapshot gives the channel of the saved models")
+{
+}
+
+PropagationSnapshotTestCase::~PropagationSnapshotTestCase ()
+{
+}
+
+void
+PropagationSnapshotTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  std::vector<Ptr<MobilityModel> > mobility;
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      Ptr<MobilityModel> m = CreateObject<ConstantPositionMobilityModel> ();
+      // the link 0-1 uses m1 (Erlang), the links to node 2 use m2 (Gamma)
+      m->SetPosition (Vector (i * i * 100.0, 0, 0));
+      nodes.Get (i)->AggregateObject (m);
+      mobility.push_back (m);
+    }
+
+  // Jakes, then the chain of CreateChain, then BlockFading: every model
+  // with a state to save
+  Ptr<PropagationLossModel> chains[2];
+  for (uint32_t k = 0; k < 2; ++k)
+    {
+      Ptr<PropagationLossModel> chain = CreateChain ();
+      chain->GetNext ()->SetAttribute ("m1", DoubleValue (2));
+      chain->GetNext ()->SetAttribute ("m2", DoubleValue (1.5));
+      chain->GetNext ()->SetNext (CreateObject<BlockFadingPropagationLossModel> ());
+      chains[k] = CreateObject<JakesPropagationLossModel> ();
+      chains[k]->SetNext (chain);
+      chains[k]->AssignStreams (1);
+    }
+  Ptr<PropagationLossModel> saved = chains[0];
+  saved->CalcRxPower (0, mobility[0], mobility[1]);
+  saved->CalcRxPower (0, mobility[0], mobility[2]);
+  Simulator::Stop (MilliSeconds (7));
+  Simulator::Run ();
+  saved->CalcRxPower (0, mobility[1], mobility[2]);
+  std::stringstream snapshot;
+  saved->Serialize (snapshot);
+
+  Ptr<PropagationLossModel> restored = chains[1];
+  restored->Deserialize (snapshot);
+  for (uint32_t step = 0; step < 3; ++step)
+    {
+      Simulator::Stop (MilliSeconds (3));
+      Simulator::Run ();
+      for (uint32_t i = 0; i < 3; ++i)
+        {
+          for (uint32_t j = i + 1; j < 3; ++j)
+            {
+              NS_TEST_EXPECT_MSG_EQ (restored->CalcRxPower (0, mobility[i], mobility[j]),
+                                     saved->CalcRxPower (0, mobility[i], mobility[j]),
+                                     "Restored channel differs on link " << i << "-" << j);
+            }
+        }
+    }
+  Simulator::Destroy ();
+}
+
+class RandomDrawLogTestCase : public TestCase
+{
+public:
+  RandomDrawLogTestCase ();
+  virtual ~RandomDrawLogTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+RandomDrawLogTestCase::RandomDrawLogTestCase ()
+  : TestCase ("Test that the draw logs keep every draw when the shape keeps changing")
+{
+}
+
+RandomDrawLogTestCase::~RandomDrawLogTestCase ()
+{
+}
+
+void
+RandomDrawLogTestCase::DoRun (void)
+{
+  RandomDrawLog ordered;
+  RandomDrawLog unordered (false);
+  for (uint32_t i = 0; i < 5000; ++i)
+    {
+      ordered.Record (i % 2 ? 0.75 : 1.5);
+      unordered.Record (i % 2 ? 1 : 2);
+    }
+  NS_TEST_EXPECT_MSG_EQ (ordered.GetNRuns (), 5000, "The ordered log should keep one run per change");
+  NS_TEST_EXPECT_MSG_EQ (ordered.GetNDraws (), 5000, "The ordered log lost draws");
+  NS_TEST_EXPECT_MSG_EQ (unordered.GetNRuns (), 2, "The unordered log should keep one total per shape");
+  NS_TEST_EXPECT_MSG_EQ (unordered.GetNDraws (), 5000, "The unordered log lost draws");
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+  Ptr<MobilityModel> near = CreateObject<ConstantPositionMobilityModel> ();
+  near->SetPosition (Vector (50, 0, 0));
+  Ptr<MobilityModel> far = CreateObject<ConstantPositionMobilityModel> ();
+  far->SetPosition (Vector (300, 0, 0));
+
+  // Erlang shapes: the links alternate fields, the snapshot stays small
+  Ptr<NakagamiPropagationLossModel> erlang = CreateObject<NakagamiPropagationLossModel> ();
+  erlang->SetAttribute ("m0", DoubleValue (1));
+  erlang->SetAttribute ("m1", DoubleValue (2));
+  erlang->SetAttribute ("m2", DoubleValue (2));
+  erlang->AssignStreams (1);
+  for (uint32_t i = 0; i < 5000; ++i)
+    {
+      erlang->CalcRxPower (0, a, i % 2 ? near : far);
+    }
+  std::stringstream snapshot;
+  erlang->Serialize (snapshot);
+  NS_TEST_EXPECT_MSG_LT (snapshot.str ().size (), 1000, "The Erlang draws should be saved as totals");
+
+  // default Gamma shapes changing on every call: the snapshot restores the order
+  Ptr<NakagamiPropagationLossModel> gamma = CreateObject<NakagamiPropagationLossModel> ();
+  gamma->AssignStreams (1);
+  for (uint32_t i = 0; i < 5000; ++i)
+    {
+      gamma->CalcRxPower (0, a, i % 2 ? near : far);
+    }
+  snapshot.str ("");
+  gamma->Serialize (snapshot);
+  Ptr<NakagamiPropagationLossModel> restored = CreateObject<NakagamiPropagationLossModel> ();
+  restored->AssignStreams (1);
+  restored->Deserialize (snapshot);
+  for (uint32_t i = 0; i < 20; ++i)
+    {
+      Ptr<MobilityModel> b = i % 2 ? near : far;
+      NS_TEST_EXPECT_MSG_EQ (restored->CalcRxPower (0, a, b), gamma->CalcRxPower (0, a, b),
+                             "Restored Gamma draw " << i << " differs");
+    }
+  Simulator::Destroy ();
+}
+
+class RecordingPropagationLossModelTestCase : public TestCase
+{
+public:
+  RecordingPropagationLossModelTestCase ();
+  virtual ~RecordingPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+RecordingPropagationLossModelTestCase::RecordingPropagationLossModelTestCase ()
+  : TestCase ("Test that RecordingPropagationLossModel records the calls of a chain")
+{
+}
+
+RecordingPropagationLossModelTestCase::~RecordingPropagationLossModelTestCase ()
+{
+}
+
+void
+RecordingPropagationLossModelTestCase::DoRun (void)
+{
+  std::vector<Ptr<MobilityModel> > mobility;
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Ptr<MobilityModel> m = CreateObject<ConstantPositionMobilityModel> ();
+      m->SetPosition (Vector (100.0 * i, 0, 1.5));
+      mobility.push_back (m);
+    }
+  std::string fileName = CreateTempDirFilename ("propagation.trace");
+  Ptr<RecordingPropagationLossModel> recorder = CreateObject<RecordingPropagationLossModel> ();
+  recorder->SetFileName (fileName);
+  recorder->SetNext (CreateObject<LogDistancePropagationLossModel> ());
+  Ptr<PropagationLossModel> reference = CreateObject<LogDistancePropagationLossModel> ();
+
+  NS_TEST_EXPECT_MSG_EQ (recorder->CalcRxPower (20, mobility[0], mobility[1]),
+                         reference->CalcRxPower (20, mobility[0], mobility[1]),
+                         "The recorder should not change the power");
+  NS_TEST_EXPECT_MSG_EQ (recorder->CalcRxPower (10, mobility[0], mobility[2]),
+                         reference->CalcRxPower (10, mobility[0], mobility[2]),
+                         "The recorder should not change the power");
+  Simulator::Stop (MilliSeconds (5));
+  Simulator::Run ();
+  mobility[1]->SetPosition (Vector (50, 50, 1.5));
+  NS_TEST_EXPECT_MSG_EQ (recorder->CalcRxPowerW (0.1, mobility[1], mobility[0]),
+                         reference->CalcRxPowerW (0.1, mobility[1], mobility[0]),
+                         "The recorder should not change the power");
+  NS_TEST_EXPECT_MSG_EQ (recorder->GetNCalls (), 3, "Wrong number of calls");
+  NS_TEST_EXPECT_MSG_EQ (recorder->GetNMobilityModels (), 3, "Wrong number of mobility models");
+  recorder->Close ();
+
+  // positions of 0 and 1, call, position of 2, call, new position of 1, call
+  PropagationTraceReader reader;
+  reader.Open (fileName);
+  PropagationTraceRecord record;
+  const char types[] = "PPCPCPC";
+  std::vector<PropagationTraceRecord> records;
+  while (reader.Read (record))
+    {
+      records.push_back (record);
+    }
+  NS_TEST_ASSERT_MSG_EQ (records.size (), 7, "Wrong number of records");
+  for (uint32_t i = 0; i < records.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (static_cast<char> (records[i].m_type), types[i], "Wrong type of record " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (records[3].m_index, 2, "Wrong index of the third mobility model");
+  NS_TEST_EXPECT_MSG_EQ (records[5].m_index, 1, "Wrong index of the moved mobility model");
+  NS_TEST_EXPECT_MSG_EQ (records[5].m_position.y, 50, "Wrong position of the moved mobility model");
+  NS_TEST_EXPECT_MSG_EQ (records[4].m_rx, 2, "Wrong receiver of the second call");
+  NS_TEST_EXPECT_MSG_EQ (records[4].m_txPowerDbm, 10, "Wrong power of the second call");
+  NS_TEST_EXPECT_MSG_EQ (records[4].m_timeStep, 0, "Wrong time of the second call");
+  NS_TEST_EXPECT_MSG_EQ (records[6].m_tx, 1, "Wrong transmitter of the third call");
+  NS_TEST_EXPECT_MSG_EQ (records[6].m_rx, 0, "Wrong receiver of the third call");
+  NS_TEST_EXPECT_MSG_EQ_TOL (records[6].m_txPowerDbm, 20, 1e-9, "Wrong power of the third call");
+  NS_TEST_EXPECT_MSG_EQ (records[6].m_timeStep, MilliSeconds (5).GetTimeStep (), "Wrong time of the third call");
+
+  // the recorder has a bounded gain, so it does not disable the cutoff of
+  // the models before it
+  NS_TEST_EXPECT_MSG_EQ (recorder->GetMaxGainDb (), 0, "The recorder should not change the power");
+  Ptr<PropagationLossModel> chain = CreateChain ();
+  Ptr<RecordingPropagationLossModel> last = CreateObject<RecordingPropagationLossModel> ();
+  last->SetFileName (CreateTempDirFilename ("skipped.trace"));
+  chain->GetNext ()->SetNext (last);
+  NS_TEST_EXPECT_MSG_EQ (chain->CalcRxPower (20, mobility[0], mobility[2], 0), -std::numeric_limits<double>::infinity (),
+                         "The cutoff should skip the Nakagami and the recorder");
+  NS_TEST_EXPECT_MSG_EQ (last->GetNCalls (), 0, "The skipped recorder should not record the call");
+  Simulator::Destroy ();
+}
+
+class PropagationSampleTestCase : public TestCase
+{
+public:
+  PropagationSampleTestCase ();
+  virtual ~PropagationSampleTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Calc (void);
+
+  Ptr<PropagationLossModel> m_model;
+  Ptr<MobilityModel> m_a;
+  Ptr<MobilityModel> m_b;
+  std::vector<double> m_rxPowerDbm;
+};
+
+PropagationSampleTestCase::PropagationSampleTestCase ()
+  : TestCase ("Test that Sample evaluates a chain as CalcRxPower at the given times")
+{
+}
+
+PropagationSampleTestCase::~PropagationSampleTestCase ()
+{
+}
+
+void
+PropagationSampleTestCase::Calc (void)
+{
+  m_rxPowerDbm.push_back (m_model->CalcRxPower (20, m_a, m_b));
+}
+
+void
+PropagationSampleTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (100, 0, 0));
+
+  Ptr<LogDistancePropagationLossModel> pathLoss = CreateObject<LogDistancePropagationLossModel> ();
+  pathLoss->SetNext (CreateObject<JakesPropagationLossModel> ());
+  pathLoss->AssignStreams (1);
+
+  const uint32_t n = 50;
+  std::vector<double> samples (7);
+  pathLoss->Sample (20, a, b, MilliSeconds (100), MilliSeconds (1), n, samples);
+  NS_TEST_ASSERT_MSG_EQ (samples.size (), n, "Sample should resize the vector to n");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), Seconds (0), "Sample should not advance the simulation time");
+
+  // the same link at the same times in the simulator
+  m_model = pathLoss;
+  m_a = a;
+  m_b = b;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Simulator::Schedule (MilliSeconds (100 + i), &PropagationSampleTestCase::Calc, this);
+    }
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_rxPowerDbm.size (), n, "Wrong number of simulated calls");
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (samples[i], m_rxPowerDbm[i], 1e-9, "Sample " << i << " differs from CalcRxPower");
+    }
+  NS_TEST_EXPECT_MSG_NE (samples[0], samples[n - 1], "The fading should vary over the samples");
+
+  // a zero interval repeats the time
+  pathLoss->Sample (20, a, b, MilliSeconds (120), Seconds (0), 3, samples);
+  NS_TEST_ASSERT_MSG_EQ (samples.size (), 3, "Sample should resize the vector to n");
+  NS_TEST_EXPECT_MSG_EQ_TOL (samples[0], m_rxPowerDbm[20], 1e-9, "Sample differs from CalcRxPower at the same time");
+  NS_TEST_EXPECT_MSG_EQ (samples[1], samples[0], "A zero interval should repeat the sample");
+  NS_TEST_EXPECT_MSG_EQ (samples[2], samples[0], "A zero interval should repeat the sample");
+
+  // models drawing per call draw per sample
+  Ptr<NakagamiPropagationLossModel> nakagami = CreateObject<NakagamiPropagationLossModel> ();
+  nakagami->AssignStreams (1);
+  nakagami->Sample (20, a, b, Seconds (0), Seconds (0), 100, samples);
+  std::sort (samples.begin (), samples.end ());
+  NS_TEST_EXPECT_MSG_EQ (std::unique (samples.begin (), samples.end ()) - samples.begin (), 100,
+                         "Every sample should draw a new value");
+
+  pathLoss->Sample (20, a, b, Seconds (0), Seconds (1), 0, samples);
+  NS_TEST_EXPECT_MSG_EQ (samples.empty (), true, "No sample was requested");
+  m_model = 0;
+  m_a = 0;
+  m_b = 0;
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +1467,20 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new BlockFadingPropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new SUIPathLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new CorrelatedShadowingLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new PowerDomainTestCase, TestCase::QUICK);
+  AddTestCase (new NakagamiInverseCdfTestCase, TestCase::QUICK);
+  AddTestCase (new CounterBasedStreamsTestCase, TestCase::QUICK);
+  AddTestCase (new PropagationCutoffTestCase, TestCase::QUICK);
+  AddTestCase (new ConstantSpeedDelayTestCase, TestCase::QUICK);
+  AddTestCase (new PropagationLinkStateTestCase, TestCase::QUICK);
+  AddTestCase (new PropagationTimingTestCase, TestCase::QUICK);
+  AddTestCase (new PropagationSnapshotTestCase, TestCase::QUICK);
+  AddTestCase (new RandomDrawLogTestCase, TestCase::QUICK);
+  AddTestCase (new RecordingPropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new PropagationSampleTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
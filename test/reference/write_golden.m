@@ -0,0 +1,87 @@
+function write_golden ()
+
+  %%
+  %% function write_golden ()
+  %%
+  %% writes the golden vectors of propagation-golden-test-suite.cc into
+  %% golden/, one file per reference function. A file is little endian:
+  %% the number of records (uint32), then for each record the frequency
+  %% [Hz], the distance [m], the base station and the mobile height [m]
+  %% and the loss [dB] (double).
+  %%
+  %% The NLOS over rooftop vectors use the default attributes of the model
+  %% (hr = 20, l = 80, b = 50, w = 20, phi = 45) and only heights above the
+  %% rooftop level.
+  %%
+  %% write_golden.py is a transcription of this function and of the
+  %% references, for machines without Octave; the committed files were
+  %% written by it.
+
+  mkdir ("golden");
+
+  d = logspace (0, log10 (20), 10);
+  write_oh ("golden/oh-large-cities-urban.bin", @loss_OH_large_cities_urban, [150e6 450e6 900e6 1500e6], d);
+  write_oh ("golden/oh-small-cities-urban.bin", @loss_OH_small_cities_urban, [150e6 450e6 900e6 1500e6], d);
+  write_oh ("golden/oh-suburban.bin", @loss_OH_suburban, [150e6 450e6 900e6 1500e6], d);
+  write_oh ("golden/oh-openareas.bin", @loss_OH_openareas, [150e6 450e6 900e6 1500e6], d);
+  write_oh ("golden/cost231-large-cities-urban.bin", @loss_COST231_large_cities_urban, [1600e6 1800e6 2000e6], d);
+  write_oh ("golden/cost231-small-cities-urban.bin", @loss_COST231_small_cities_urban, [1600e6 1800e6 2000e6], d);
+
+  r = [];
+  for f = [800e6 2160e6 5800e6]
+    for hb = [5 10 20]
+      for hm = [1 1.5 2]
+        for dm = logspace (log10 (25), 3, 12)
+          r = [r; f dm hb hm loss_ITU1411_LOS(dm, hb, hm, f)];
+        endfor
+      endfor
+    endfor
+  endfor
+  write_records ("golden/itu1411-los.bin", r);
+
+  r = [];
+  for f = [800e6 1500e6 2160e6 5000e6]
+    for hb = [25 30 40 60]
+      for hm = [1.5 5 10]
+        for dm = logspace (2, log10 (5000), 12)
+          r = [r; f dm hb hm loss_ITU1411_NLOS_over_rooftop(dm, hb, hm, 20, f, 80, 50, 20, 45, 0)];
+        endfor
+      endfor
+    endfor
+  endfor
+  write_records ("golden/itu1411-nlos-over-rooftop.bin", r);
+
+  r = [];
+  for dm = logspace (1, log10 (5000), 40)
+    r = [r; 2600e6 dm 30 1.5 loss_Kun_2_6GHz(dm)];
+  endfor
+  write_records ("golden/kun-2600-mhz.bin", r);
+
+endfunction
+
+function write_oh (name, loss, freqs, dkm)
+
+  %% the Okumura Hata references take the frequency in MHz and the
+  %% distance in km
+  r = [];
+  for f = freqs
+    for hb = [30 50 100 200]
+      for hm = [1 2 5 10]
+        for dk = dkm
+          r = [r; f dk*1000 hb hm loss(dk, hb, hm, f/1e6)];
+        endfor
+      endfor
+    endfor
+  endfor
+  write_records (name, r);
+
+endfunction
+
+function write_records (name, r)
+
+  fid = fopen (name, "w");
+  fwrite (fid, rows (r), "uint32", 0, "ieee-le");
+  fwrite (fid, r', "double", 0, "ieee-le");
+  fclose (fid);
+
+endfunction
@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+"""Writes the golden vectors of propagation-golden-test-suite.cc into golden/.
+
+This is a line by line transcription of write_golden.m and of the loss_*.m
+reference functions, for machines without Octave; the committed golden
+files were produced by it. Both write the same grids in the same format:
+the number of records (uint32), then for each record the frequency [Hz],
+the distance [m], the base station and the mobile height [m] and the loss
+[dB] (double), all little endian. Run it from test/reference; it needs
+numpy for logspace.
+"""
+
+import math
+import os
+import struct
+
+import numpy
+
+log10 = math.log10
+
+
+def loss_OH_large_cities_urban(d, hb, hm, f):
+    if f < 200:
+        Ch = 8.29 * (log10(1.54 * hm)) ** 2 - 1.1
+    else:
+        Ch = 3.2 * (log10(11.75 * hm)) ** 2 - 4.97
+    return 69.55 + 26.16 * log10(f) - 13.82 * log10(hb) + (44.9 - 6.55 * log10(hb)) * log10(d) - Ch
+
+
+def ch_small_cities(hm, f):
+    return 0.8 + (1.1 * log10(f) - 0.7) * hm - (1.56 * log10(f))
+
+
+def loss_OH_small_cities_urban(d, hb, hm, f):
+    return 69.55 + 26.16 * log10(f) - 13.82 * log10(hb) + (44.9 - 6.55 * log10(hb)) * log10(d) - ch_small_cities(hm, f)
+
+
+def loss_OH_suburban(d, hb, hm, f):
+    return loss_OH_small_cities_urban(d, hb, hm, f) - 2 * (log10(f / 28)) ** 2 - 5.4
+
+
+def loss_OH_openareas(d, hb, hm, f):
+    return loss_OH_small_cities_urban(d, hb, hm, f) - 4.70 * (log10(f)) ** 2 + 18.33 * log10(f) - 40.94
+
+
+def loss_COST231_large_cities_urban(d, hb, hm, f):
+    Fhm = 3.2 * (log10(11.75 * hm)) ** 2
+    C = 3
+    return 46.3 + 33.9 * log10(f) - 13.82 * log10(hb) + (44.9 - 6.55 * log10(hb)) * log10(d) - Fhm + C
+
+
+def loss_COST231_small_cities_urban(d, hb, hm, f):
+    Fhm = (1.1 * log10(f)) - (0.7 * hm) - (1.56 * log10(f) - 0.8)
+    C = 0
+    return 46.3 + 33.9 * log10(f) - 13.82 * log10(hb) + (44.9 - 6.55 * log10(hb)) * log10(d) - Fhm + C
+
+
+def loss_ITU1411_LOS(d, hb, hm, f):
+    lam = 299792458 / f
+    Lbp = abs(20 * log10(lam ** 2 / (8 * math.pi * hb * hm)))
+    Rbp = 4 * hb * hm / lam
+    if d <= Rbp:
+        Ll = Lbp + 20 * log10(d / Rbp)
+        Lu = Lbp + 20 + 25 * log10(d / Rbp)
+    else:
+        Ll = Lbp + 40 * log10(d / Rbp)
+        Lu = Lbp + 20 + 40 * log10(d / Rbp)
+    return (Ll + Lu) / 2
+
+
+def loss_ITU1411_NLOS_over_rooftop(d, hb, hm, hr, f, l, b, w, phi, big):
+    lam = 299792458 / f
+    fmhz = f / 1e6
+    Dhb = hb - hr
+    ds = lam * d * d / (Dhb * Dhb)
+    if l > ds:
+        if fmhz > 2000:
+            kf = -8
+        elif big == 1:
+            kf = -4 + 1.5 * ((fmhz / 925) - 1)
+        else:
+            kf = -4 + 0.7 * ((fmhz / 925) - 1)
+        if hb > hr:
+            kd = 18
+            ka = 71.4 if fmhz > 2000 else 54
+            Lbsh = -18 * log10(1 + Dhb)
+        else:
+            kd = 18 - 15 * (Dhb / hr)
+            Lbsh = 0
+            ka = 54 - 0.8 * Dhb if d >= 500 else 54 - 1.6 * Dhb
+        Lmsd = Lbsh + ka + kd * log10(d / 1000) + kf * log10(fmhz) - 9 * log10(b)
+    else:
+        theta = math.atan(Dhb / b)
+        rho = math.sqrt(Dhb ** 2 + b ** 2)
+        if abs(hb - hr) < 1:
+            Qm = b / d
+        elif hb > hr:
+            Qm = 2.35 * ((Dhb / d) * math.sqrt(b / lam)) ** 0.9
+        else:
+            Qm = (b / (2 * math.pi * d)) * math.sqrt(lam / rho) * ((1 / theta) - (1 / (2 * math.pi + theta)))
+        Lmsd = -10 * log10(Qm * Qm)
+    Dhm = hr - hm
+    if phi < 35:
+        Lori = -10 + 0.354 * phi
+    elif phi < 55:
+        Lori = 2.5 + 0.075 * (phi - 35)
+    else:
+        Lori = 4 - 0.114 * (phi - 55)
+    Lrts = -8.2 - 10 * log10(w) + 10 * log10(fmhz) + 20 * log10(Dhm) + Lori
+    Lbf = 32.4 + 20 * log10(d / 1000) + 20 * log10(fmhz)
+    if Lrts + Lmsd > 0:
+        return Lbf + Lrts + Lmsd
+    return Lbf
+
+
+def loss_Kun_2_6GHz(d):
+    return 36 + 26 * log10(d)
+
+
+def write_records(name, r):
+    with open(name, "wb") as fid:
+        fid.write(struct.pack("<I", len(r)))
+        for record in r:
+            fid.write(struct.pack("<5d", *record))
+
+
+def write_oh(name, loss, freqs, dkm):
+    # the Okumura Hata references take the frequency in MHz and the
+    # distance in km
+    r = []
+    for f in freqs:
+        for hb in [30, 50, 100, 200]:
+            for hm in [1, 2, 5, 10]:
+                for dk in dkm:
+                    r.append((f, dk * 1000, hb, hm, loss(dk, hb, hm, f / 1e6)))
+    write_records(name, r)
+
+
+def write_golden():
+    if not os.path.isdir("golden"):
+        os.mkdir("golden")
+
+    d = numpy.logspace(0, log10(20), 10)
+    write_oh("golden/oh-large-cities-urban.bin", loss_OH_large_cities_urban, [150e6, 450e6, 900e6, 1500e6], d)
+    write_oh("golden/oh-small-cities-urban.bin", loss_OH_small_cities_urban, [150e6, 450e6, 900e6, 1500e6], d)
+    write_oh("golden/oh-suburban.bin", loss_OH_suburban, [150e6, 450e6, 900e6, 1500e6], d)
+    write_oh("golden/oh-openareas.bin", loss_OH_openareas, [150e6, 450e6, 900e6, 1500e6], d)
+    write_oh("golden/cost231-large-cities-urban.bin", loss_COST231_large_cities_urban, [1600e6, 1800e6, 2000e6], d)
+    write_oh("golden/cost231-small-cities-urban.bin", loss_COST231_small_cities_urban, [1600e6, 1800e6, 2000e6], d)
+
+    r = []
+    for f in [800e6, 2160e6, 5800e6]:
+        for hb in [5, 10, 20]:
+            for hm in [1, 1.5, 2]:
+                for dm in numpy.logspace(log10(25), 3, 12):
+                    r.append((f, dm, hb, hm, loss_ITU1411_LOS(dm, hb, hm, f)))
+    write_records("golden/itu1411-los.bin", r)
+
+    r = []
+    for f in [800e6, 1500e6, 2160e6, 5000e6]:
+        for hb in [25, 30, 40, 60]:
+            for hm in [1.5, 5, 10]:
+                for dm in numpy.logspace(2, log10(5000), 12):
+                    r.append((f, dm, hb, hm, loss_ITU1411_NLOS_over_rooftop(dm, hb, hm, 20, f, 80, 50, 20, 45, 0)))
+    write_records("golden/itu1411-nlos-over-rooftop.bin", r)
+
+    r = []
+    for dm in numpy.logspace(1, log10(5000), 40):
+        r.append((2600e6, dm, 30, 1.5, loss_Kun_2_6GHz(dm)))
+    write_records("golden/kun-2600-mhz.bin", r)
+
+
+if __name__ == "__main__":
+    write_golden()